@@ -111,6 +111,9 @@ ifeq ($(strip $(RGBLIGHT_ENABLE)), yes)
         OPT_DEFS += -DRGBLIGHT_CUSTOM_DRIVER
     else
         SRC += ws2812.c
+        ifeq ($(PLATFORM),CHIBIOS)
+            SRC += ws2812_encode.c
+        endif
     endif
 endif
 
@@ -144,6 +147,7 @@ endif
     SRC += $(QUANTUM_DIR)/rgb_matrix.c
     SRC += $(QUANTUM_DIR)/rgb_matrix_drivers.c
     CIE1931_CURVE = yes
+    FIXED_MATH = yes
 endif
 
 ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
@@ -229,6 +233,10 @@ ifeq ($(strip $(LED_TABLES)), yes)
     SRC += $(QUANTUM_DIR)/led_tables.c
 endif
 
+ifeq ($(strip $(FIXED_MATH)), yes)
+    SRC += $(QUANTUM_DIR)/fixed_math.c
+endif
+
 ifeq ($(strip $(TERMINAL_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/process_keycode/process_terminal.c
     OPT_DEFS += -DTERMINAL_ENABLE
@@ -239,6 +247,15 @@ ifeq ($(strip $(USB_HID_ENABLE)), yes)
     include $(TMK_DIR)/protocol/usb_hid.mk
 endif
 
+ifeq ($(strip $(I2C_QUEUE_ENABLE)), yes)
+    # The queue is sent by the ChibiOS i2c_master, the tests bring their own
+    ifeq ($(filter $(PLATFORM),CHIBIOS TEST),)
+        $(error I2C_QUEUE_ENABLE is only supported on ChibiOS)
+    endif
+    SRC += i2c_queue.c
+    OPT_DEFS += -DI2C_QUEUE_ENABLE
+endif
+
 ifeq ($(strip $(ENCODER_ENABLE)), yes)
     SRC += $(QUANTUM_DIR)/encoder.c
     OPT_DEFS += -DENCODER_ENABLE
@@ -312,7 +329,8 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
 
     # Include files used by all split keyboards
     QUANTUM_SRC += $(QUANTUM_DIR)/split_common/split_flags.c \
-                   $(QUANTUM_DIR)/split_common/split_util.c
+                   $(QUANTUM_DIR)/split_common/split_util.c \
+                   $(QUANTUM_DIR)/split_common/split_state.c
 
     # Determine which (if any) transport files are required
     ifneq ($(strip $(SPLIT_TRANSPORT)), custom)
@@ -30,6 +30,14 @@
 #include <string.h>
 #include <hal.h>
 
+#ifdef I2C_QUEUE_ENABLE
+  #include "i2c_queue.h"
+  // blocking transfers must not overtake writes that are still queued
+  #define I2C_QUEUE_BARRIER() i2c_queue_flush()
+#else
+  #define I2C_QUEUE_BARRIER()
+#endif
+
 static uint8_t i2c_address;
 
 // This configures the I2C clock to 400khz assuming a 72Mhz clock
@@ -67,6 +75,7 @@ uint8_t i2c_start(uint8_t address)
 
 uint8_t i2c_transmit(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout)
 {
+  I2C_QUEUE_BARRIER();
   i2c_address = address;
   i2cStart(&I2C_DRIVER, &i2cconfig);
   return i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, MS2ST(timeout));
@@ -74,6 +83,7 @@ uint8_t i2c_transmit(uint8_t address, uint8_t* data, uint16_t length, uint16_t t
 
 uint8_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout)
 {
+  I2C_QUEUE_BARRIER();
   i2c_address = address;
   i2cStart(&I2C_DRIVER, &i2cconfig);
   return i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, MS2ST(timeout));
@@ -81,6 +91,7 @@ uint8_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t ti
 
 uint8_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout)
 {
+  I2C_QUEUE_BARRIER();
   i2c_address = devaddr;
   i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -96,11 +107,65 @@ uint8_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t l
 
 uint8_t i2c_readReg(uint8_t devaddr, uint8_t* regaddr, uint8_t* data, uint16_t length, uint16_t timeout)
 {
+  I2C_QUEUE_BARRIER();
   i2c_address = devaddr;
   i2cStart(&I2C_DRIVER, &i2cconfig);
   return i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), regaddr, 1, data, length, MS2ST(timeout));
 }
 
+#ifdef I2C_QUEUE_ENABLE
+#ifndef I2C_QUEUE_TIMEOUT
+  #define I2C_QUEUE_TIMEOUT 100
+#endif
+
+static THD_WORKING_AREA(waI2CQueueThread, 256);
+static binary_semaphore_t i2c_queue_kick;
+static bool i2c_queue_thread_started = false;
+
+// Drains the queue in the background. The transfer itself is DMA driven, so
+// this thread sleeps while the bus is busy and the scan loop keeps running.
+static THD_FUNCTION(I2CQueueThread, arg)
+{
+  (void)arg;
+  chRegSetThreadName("i2c_queue");
+
+  while (true) {
+    uint8_t address;
+    const uint8_t *data;
+    uint16_t length;
+
+    chBSemWait(&i2c_queue_kick);
+
+#if I2C_USE_MUTUAL_EXCLUSION
+    i2cAcquireBus(&I2C_DRIVER);
+#endif
+    while (i2c_queue_next(&address, &data, &length)) {
+      i2cStart(&I2C_DRIVER, &i2cconfig);
+      msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (address >> 1), data, length, 0, 0, MS2ST(I2C_QUEUE_TIMEOUT));
+      i2c_queue_complete(status == MSG_OK ? I2C_QUEUE_STATUS_OK : (uint8_t)status);
+    }
+#if I2C_USE_MUTUAL_EXCLUSION
+    i2cReleaseBus(&I2C_DRIVER);
+#endif
+  }
+}
+
+void i2c_queue_bus_kick(void)
+{
+  if (!i2c_queue_thread_started) {
+    i2c_queue_thread_started = true;
+    chBSemObjectInit(&i2c_queue_kick, true);
+    chThdCreateStatic(waI2CQueueThread, sizeof(waI2CQueueThread), NORMALPRIO, I2CQueueThread, NULL);
+  }
+  chBSemSignal(&i2c_queue_kick);
+}
+
+void i2c_queue_bus_wait(void)
+{
+  chThdSleepMilliseconds(1);
+}
+#endif
+
 // This is usually not needed. It releases the driver to allow pins to become GPIO again.
 uint8_t i2c_stop(uint16_t timeout)
 {
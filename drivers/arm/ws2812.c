@@ -0,0 +1,110 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ch.h"
+#include "hal.h"
+#include "quantum.h"
+#include "ws2812.h"
+#include "ws2812_encode.h"
+
+#define WS2812_BUFFER_SIZE WS2812_ENCODED_SIZE(RGBLED_NUM * sizeof(LED_TYPE))
+
+static uint8_t ws2812_buffers[2][WS2812_BUFFER_SIZE];
+static uint16_t ws2812_lengths[2];
+
+// Only changed with the system locked
+static ws2812_frames_t ws2812_frames;
+
+static binary_semaphore_t ws2812_kick;
+static bool ws2812_initialized = false;
+
+static const SPIConfig ws2812_spi_config = {
+  NULL,
+  WS2812_SPI_MOSI_BANK,
+  WS2812_SPI_MOSI_PIN,
+  WS2812_SPI_BAUD
+};
+
+static THD_WORKING_AREA(waWS2812Thread, 128);
+static THD_FUNCTION(WS2812Thread, arg)
+{
+  (void)arg;
+  chRegSetThreadName("ws2812");
+
+  while (true) {
+    chBSemWait(&ws2812_kick);
+
+    chSysLock();
+    uint8_t index = ws2812_frames_next(&ws2812_frames);
+    chSysUnlock();
+
+    if (index != WS2812_NO_BUFFER) {
+      // blocks this thread only, the transfer itself runs on DMA
+      spiSend(&WS2812_SPI, ws2812_lengths[index], ws2812_buffers[index]);
+    }
+
+    chSysLock();
+    ws2812_frames_sent(&ws2812_frames);
+    chSysUnlock();
+  }
+}
+
+static void ws2812_init(void)
+{
+  palSetPadMode(WS2812_SPI_MOSI_BANK, WS2812_SPI_MOSI_PIN, WS2812_SPI_MOSI_PAL_MODE);
+  spiStart(&WS2812_SPI, &ws2812_spi_config);
+
+  ws2812_frames_init(&ws2812_frames);
+  chBSemObjectInit(&ws2812_kick, true);
+  chThdCreateStatic(waWS2812Thread, sizeof(waWS2812Thread), NORMALPRIO, WS2812Thread, NULL);
+  ws2812_initialized = true;
+}
+
+static void ws2812_send(const uint8_t *data, uint16_t length)
+{
+  if (!ws2812_initialized) {
+    ws2812_init();
+  }
+
+  // Take back a frame the thread has not picked up yet, it is about to be
+  // replaced anyway, and encode into whichever buffer is not on the wire.
+  // data is the whole strip, so it also holds the LEDs a longer frame taken
+  // back would have sent.
+  chSysLock();
+  uint8_t index = ws2812_frames_claim(&ws2812_frames, &length);
+  chSysUnlock();
+
+  ws2812_lengths[index] = ws2812_encode(data, length, ws2812_buffers[index]);
+
+  chSysLock();
+  ws2812_frames_ready(&ws2812_frames, index, length);
+  chSysUnlock();
+  chBSemSignal(&ws2812_kick);
+}
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds)
+{
+  if (number_of_leds > RGBLED_NUM) {
+    number_of_leds = RGBLED_NUM;
+  }
+  ws2812_send((const uint8_t *)ledarray, number_of_leds * sizeof(LED_TYPE));
+}
+
+void ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t number_of_leds)
+{
+  // LED_TYPE already carries the white channel when RGBW is defined
+  ws2812_setleds(ledarray, number_of_leds);
+}
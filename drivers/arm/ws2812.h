@@ -0,0 +1,56 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "rgblight_types.h"
+
+/* WS2812 driver for ChibiOS.
+ *
+ * The LED data is encoded into an SPI bit stream (see ws2812_encode.h) and
+ * sent with DMA from a background thread, so ws2812_setleds() returns as
+ * soon as the frame is encoded. There are two encode buffers: a new frame is
+ * prepared in one while the other is on the wire, and if frames come faster
+ * than the strip takes them only the newest is sent.
+ *
+ * Please ensure that HAL_USE_SPI is TRUE in halconf.h and that the SPI
+ * driver used is enabled in mcuconf.h. Only the MOSI pin is used.
+ */
+
+#ifndef WS2812_SPI
+  #define WS2812_SPI SPID1
+#endif
+
+#ifndef WS2812_SPI_MOSI_BANK
+  #define WS2812_SPI_MOSI_BANK GPIOA
+#endif
+
+#ifndef WS2812_SPI_MOSI_PIN
+  #define WS2812_SPI_MOSI_PIN 7
+#endif
+
+#ifndef WS2812_SPI_MOSI_PAL_MODE
+  #define WS2812_SPI_MOSI_PAL_MODE PAL_MODE_ALTERNATE(5)
+#endif
+
+// Baud rate bits of SPI_CR1, chosen for an SPI clock of about 2.25 MHz.
+// The default divides a 72 MHz APB2 clock by 32.
+#ifndef WS2812_SPI_BAUD
+  #define WS2812_SPI_BAUD SPI_CR1_BR_2
+#endif
+
+void ws2812_setleds     (LED_TYPE *ledarray, uint16_t number_of_leds);
+void ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t number_of_leds);
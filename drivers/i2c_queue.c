@@ -0,0 +1,173 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_queue.h"
+#include <string.h>
+
+#if (I2C_QUEUE_SIZE & (I2C_QUEUE_SIZE - 1)) != 0 || I2C_QUEUE_SIZE > 128
+  #error "I2C_QUEUE_SIZE must be a power of two no larger than 128"
+#endif
+
+#ifdef PROTOCOL_CHIBIOS
+  #include "ch.h"
+  #define I2C_QUEUE_LOCK()   chSysLock()
+  #define I2C_QUEUE_UNLOCK() chSysUnlock()
+#else
+  #define I2C_QUEUE_LOCK()
+  #define I2C_QUEUE_UNLOCK()
+#endif
+
+#define I2C_QUEUE_INDEX(n) ((n) & (I2C_QUEUE_SIZE - 1))
+
+typedef struct {
+  uint8_t address;
+  uint8_t status;
+  uint16_t offset;
+  uint16_t length;
+  i2c_queue_callback_t callback;
+  void *arg;
+} i2c_queue_transaction_t;
+
+static i2c_queue_transaction_t i2c_queue[I2C_QUEUE_SIZE];
+static uint8_t i2c_queue_data[I2C_QUEUE_BUFFER_SIZE];
+
+// Free running counters: head is the next slot to fill, sent the next one
+// to hand to the backend, done the next one to complete and tail the next
+// one to retire. Only sent and done are touched by the backend.
+static volatile uint8_t i2c_queue_head = 0;
+static volatile uint8_t i2c_queue_sent = 0;
+static volatile uint8_t i2c_queue_done = 0;
+static uint8_t i2c_queue_tail = 0;
+
+// Data of the retained transactions lives between data_tail and data_head,
+// wrapping to the start of the buffer when a transfer does not fit the end.
+static uint16_t i2c_queue_data_head = 0;
+static uint16_t i2c_queue_data_tail = 0;
+
+static bool i2c_queue_alloc(uint16_t length, uint16_t *offset) {
+  if (i2c_queue_head == i2c_queue_tail) {
+    i2c_queue_data_head = 0;
+    i2c_queue_data_tail = 0;
+  }
+
+  if ((uint8_t)(i2c_queue_head - i2c_queue_tail) == I2C_QUEUE_SIZE) {
+    return false;
+  }
+
+  if (i2c_queue_data_head >= i2c_queue_data_tail) {
+    if (I2C_QUEUE_BUFFER_SIZE - i2c_queue_data_head >= length) {
+      *offset = i2c_queue_data_head;
+      return true;
+    }
+    // keep head strictly behind tail so a full buffer never looks empty
+    if (length < i2c_queue_data_tail) {
+      *offset = 0;
+      return true;
+    }
+    return false;
+  }
+
+  if (i2c_queue_data_head + length < i2c_queue_data_tail) {
+    *offset = i2c_queue_data_head;
+    return true;
+  }
+  return false;
+}
+
+bool i2c_queue_write(uint8_t address, uint8_t reg, const uint8_t *data, uint16_t length, i2c_queue_callback_t callback, void *arg) {
+  uint16_t total = length + 1;
+  uint16_t offset;
+
+  if (total >= I2C_QUEUE_BUFFER_SIZE) {
+    return false;
+  }
+
+  while (!i2c_queue_alloc(total, &offset)) {
+    i2c_queue_bus_kick();
+    i2c_queue_bus_wait();
+    i2c_queue_task();
+  }
+
+  i2c_queue_transaction_t *transaction = &i2c_queue[I2C_QUEUE_INDEX(i2c_queue_head)];
+  transaction->address = address;
+  transaction->status = I2C_QUEUE_STATUS_OK;
+  transaction->offset = offset;
+  transaction->length = total;
+  transaction->callback = callback;
+  transaction->arg = arg;
+
+  i2c_queue_data[offset] = reg;
+  memcpy(&i2c_queue_data[offset + 1], data, length);
+  i2c_queue_data_head = offset + total;
+
+  I2C_QUEUE_LOCK();
+  i2c_queue_head++;
+  I2C_QUEUE_UNLOCK();
+
+  i2c_queue_bus_kick();
+  return true;
+}
+
+void i2c_queue_task(void) {
+  while (i2c_queue_tail != i2c_queue_done) {
+    i2c_queue_transaction_t *transaction = &i2c_queue[I2C_QUEUE_INDEX(i2c_queue_tail)];
+
+    i2c_queue_data_tail = transaction->offset + transaction->length;
+    i2c_queue_tail++;
+
+    if (transaction->callback) {
+      transaction->callback(transaction->status, transaction->arg);
+    }
+  }
+}
+
+void i2c_queue_flush(void) {
+  while (i2c_queue_tail != i2c_queue_head) {
+    i2c_queue_bus_kick();
+    if (i2c_queue_tail == i2c_queue_done) {
+      i2c_queue_bus_wait();
+    }
+    i2c_queue_task();
+  }
+}
+
+bool i2c_queue_is_idle(void) {
+  return i2c_queue_tail == i2c_queue_head;
+}
+
+bool i2c_queue_next(uint8_t *address, const uint8_t **data, uint16_t *length) {
+  bool available = false;
+
+  I2C_QUEUE_LOCK();
+  if (i2c_queue_sent != i2c_queue_head) {
+    i2c_queue_transaction_t *transaction = &i2c_queue[I2C_QUEUE_INDEX(i2c_queue_sent)];
+    *address = transaction->address;
+    *data = &i2c_queue_data[transaction->offset];
+    *length = transaction->length;
+    i2c_queue_sent++;
+    available = true;
+  }
+  I2C_QUEUE_UNLOCK();
+
+  return available;
+}
+
+void i2c_queue_complete(uint8_t status) {
+  I2C_QUEUE_LOCK();
+  i2c_queue[I2C_QUEUE_INDEX(i2c_queue_done)].status = status;
+  i2c_queue_done++;
+  I2C_QUEUE_UNLOCK();
+}
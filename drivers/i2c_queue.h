@@ -0,0 +1,70 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Non-blocking I2C write queue.
+ *
+ * Writes are copied into a ring buffer and sent in order by a platform
+ * backend while the caller goes back to scanning. As with i2c_master,
+ * addresses are expected to be already shifted (addr << 1).
+ *
+ * The backend pulls transactions with i2c_queue_next() and reports each one
+ * with i2c_queue_complete(). Completion callbacks are deferred to
+ * i2c_queue_task(), so they always run from the main loop.
+ */
+
+#ifndef I2C_QUEUE_SIZE
+  #define I2C_QUEUE_SIZE 16
+#endif
+
+#ifndef I2C_QUEUE_BUFFER_SIZE
+  #define I2C_QUEUE_BUFFER_SIZE 512
+#endif
+
+#define I2C_QUEUE_STATUS_OK 0
+
+typedef void (*i2c_queue_callback_t)(uint8_t status, void *arg);
+
+// Queues reg followed by length bytes of data. The data is copied, so the
+// caller may reuse its buffer straight away. Blocks only while the queue is
+// full; returns false if the transfer could never fit.
+bool i2c_queue_write(uint8_t address, uint8_t reg, const uint8_t *data, uint16_t length, i2c_queue_callback_t callback, void *arg);
+
+// Retires finished transactions and runs their callbacks.
+void i2c_queue_task(void);
+
+// Waits until every queued transaction has been sent and retired.
+void i2c_queue_flush(void);
+
+bool i2c_queue_is_idle(void);
+
+/* Backend interface */
+
+// Returns the oldest transaction that has not been handed out yet.
+bool i2c_queue_next(uint8_t *address, const uint8_t **data, uint16_t *length);
+
+// Reports the result of the transaction returned by the last i2c_queue_next().
+void i2c_queue_complete(uint8_t status);
+
+// Provided by the platform: start sending if the bus is idle.
+void i2c_queue_bus_kick(void);
+
+// Provided by the platform: give the bus a chance to make progress.
+void i2c_queue_bus_wait(void);
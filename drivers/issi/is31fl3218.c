@@ -15,6 +15,9 @@
  */
 #include "is31fl3218.h"
 #include "i2c_master.h"
+#ifdef I2C_QUEUE_ENABLE
+#include "i2c_queue.h"
+#endif
 
 // This is the full 8-bit address
 #define ISSI_ADDRESS 0b10101000
@@ -39,19 +42,27 @@ bool g_pwm_buffer_update_required = false;
 
 void IS31FL3218_write_register( uint8_t reg, uint8_t data )
 {
+#ifdef I2C_QUEUE_ENABLE
+	i2c_queue_write( ISSI_ADDRESS, reg, &data, 1, NULL, NULL );
+#else
 	g_twi_transfer_buffer[0] = reg;
 	g_twi_transfer_buffer[1] = data;
 	i2c_transmit( ISSI_ADDRESS, g_twi_transfer_buffer, 2, ISSI_TIMEOUT);
+#endif
 }
 
 void IS31FL3218_write_pwm_buffer( uint8_t *pwm_buffer )
 {
+#ifdef I2C_QUEUE_ENABLE
+	i2c_queue_write( ISSI_ADDRESS, ISSI_REG_PWM, pwm_buffer, 18, NULL, NULL );
+#else
 	g_twi_transfer_buffer[0] = ISSI_REG_PWM;
 	for ( int i=0; i<18; i++ ) {
 		g_twi_transfer_buffer[1+i] = pwm_buffer[i];
 	}
 	
 	i2c_transmit( ISSI_ADDRESS, g_twi_transfer_buffer, 19, ISSI_TIMEOUT);
+#endif
 }
 
 void IS31FL3218_init(void)
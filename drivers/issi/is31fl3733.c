@@ -27,6 +27,9 @@
 #include "is31fl3733.h"
 #include <string.h>
 #include "i2c_master.h"
+#ifdef I2C_QUEUE_ENABLE
+#include "i2c_queue.h"
+#endif
 #include "progmem.h"
 
 // This is a 7-bit address, that gets left-shifted and bit 0
@@ -76,6 +79,9 @@ uint8_t g_twi_transfer_buffer[20];
 // probably not worth the extra complexity.
 uint8_t g_pwm_buffer[DRIVER_COUNT][192];
 bool g_pwm_buffer_update_required = false;
+// One bit for each 16 byte block of g_pwm_buffer that changed since it was
+// last sent, so a flush only transfers the registers that need it.
+uint16_t g_pwm_buffer_dirty_blocks[DRIVER_COUNT] = { 0 };
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24] = { { 0 }, { 0 } };
 bool g_led_control_registers_update_required = false;
@@ -85,7 +91,9 @@ void IS31FL3733_write_register( uint8_t addr, uint8_t reg, uint8_t data )
     g_twi_transfer_buffer[0] = reg;
     g_twi_transfer_buffer[1] = data;
 
-  #if ISSI_PERSISTENCE > 0
+  #ifdef I2C_QUEUE_ENABLE
+    i2c_queue_write(addr << 1, reg, &data, 1, NULL, NULL);
+  #elif ISSI_PERSISTENCE > 0
     for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
       if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 2, ISSI_TIMEOUT) == 0)
         break;
@@ -112,7 +120,9 @@ void IS31FL3733_write_pwm_buffer( uint8_t addr, uint8_t *pwm_buffer )
             g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
         }
 
-    #if ISSI_PERSISTENCE > 0
+    #ifdef I2C_QUEUE_ENABLE
+      i2c_queue_write(addr << 1, g_twi_transfer_buffer[0], g_twi_transfer_buffer + 1, 16, NULL, NULL);
+    #elif ISSI_PERSISTENCE > 0
       for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
         if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0)
           break;
@@ -123,6 +133,57 @@ void IS31FL3733_write_pwm_buffer( uint8_t addr, uint8_t *pwm_buffer )
     }
 }
 
+bool IS31FL3733_write_pwm_buffer_range( uint8_t addr, uint8_t *pwm_buffer, uint8_t offset, uint8_t length )
+{
+    // device will auto-increment register for data after the first byte,
+    // so a whole run of blocks goes out in one transfer
+  #ifdef I2C_QUEUE_ENABLE
+    return i2c_queue_write(addr << 1, offset, pwm_buffer + offset, length, NULL, NULL);
+  #elif ISSI_PERSISTENCE > 0
+    for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
+      if (i2c_writeReg(addr << 1, offset, pwm_buffer + offset, length, ISSI_TIMEOUT) == 0)
+        return true;
+    }
+    return false;
+  #else
+    return i2c_writeReg(addr << 1, offset, pwm_buffer + offset, length, ISSI_TIMEOUT) == 0;
+  #endif
+}
+
+// The same in is31fl3731.c, is31fl3733.c and is31fl3736.c, keep them in sync
+static void IS31FL3733_write_dirty_pwm_blocks( uint8_t addr, uint8_t driver )
+{
+    uint16_t dirty = g_pwm_buffer_dirty_blocks[driver];
+    uint8_t block = 0;
+
+    // send each run of adjacent dirty blocks in a single transfer, a run
+    // that fails stays dirty so the next flush sends it again
+    while ( dirty ) {
+        if ( dirty & 1 ) {
+            uint8_t first = block;
+            while ( dirty & 1 ) {
+                dirty >>= 1;
+                block++;
+            }
+            if ( IS31FL3733_write_pwm_buffer_range( addr, g_pwm_buffer[driver], first * 16, ( block - first ) * 16 ) ) {
+                g_pwm_buffer_dirty_blocks[driver] &= ~( ( 1 << block ) - ( 1 << first ) );
+            }
+        } else {
+            dirty >>= 1;
+            block++;
+        }
+    }
+}
+
+static void IS31FL3733_set_pwm( uint8_t driver, uint8_t index, uint8_t value )
+{
+    if ( g_pwm_buffer[driver][index] != value ) {
+        g_pwm_buffer[driver][index] = value;
+        g_pwm_buffer_dirty_blocks[driver] |= 1 << ( index / 16 );
+        g_pwm_buffer_update_required = true;
+    }
+}
+
 void IS31FL3733_init( uint8_t addr )
 {
     // In order to avoid the LEDs being driven with garbage data
@@ -176,10 +237,21 @@ void IS31FL3733_set_color( int index, uint8_t red, uint8_t green, uint8_t blue )
     if ( index >= 0 && index < DRIVER_LED_TOTAL ) {
         is31_led led = g_is31_leds[index];
 
-        g_pwm_buffer[led.driver][led.r] = red;
-        g_pwm_buffer[led.driver][led.g] = green;
-        g_pwm_buffer[led.driver][led.b] = blue;
-        g_pwm_buffer_update_required = true;
+        IS31FL3733_set_pwm( led.driver, led.r, red );
+        IS31FL3733_set_pwm( led.driver, led.g, green );
+        IS31FL3733_set_pwm( led.driver, led.b, blue );
+    }
+}
+
+void IS31FL3733_set_color_buffer( const RGB *leds )
+{
+    for ( int i = 0; i < DRIVER_LED_TOTAL; i++ )
+    {
+        is31_led led = g_is31_leds[i];
+
+        IS31FL3733_set_pwm( led.driver, led.r, leds[i].r );
+        IS31FL3733_set_pwm( led.driver, led.g, leds[i].g );
+        IS31FL3733_set_pwm( led.driver, led.b, leds[i].b );
     }
 }
 
@@ -224,16 +296,39 @@ void IS31FL3733_set_led_control_register( uint8_t index, bool red, bool green, b
 
 void IS31FL3733_update_pwm_buffers( uint8_t addr1, uint8_t addr2 )
 {
-    if ( g_pwm_buffer_update_required )
+    if ( g_pwm_buffer_update_required && g_pwm_buffer_dirty_blocks[0] )
     {
         // Firstly we need to unlock the command register and select PG1
         IS31FL3733_write_register( addr1, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5 );
         IS31FL3733_write_register( addr1, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM );
 
-        IS31FL3733_write_pwm_buffer( addr1, g_pwm_buffer[0] );
-        //IS31FL3733_write_pwm_buffer( addr2, g_pwm_buffer[1] );
+        IS31FL3733_write_dirty_pwm_blocks( addr1, 0 );
+        //IS31FL3733_write_dirty_pwm_blocks( addr2, 1 );
+    }
+    g_pwm_buffer_update_required = g_pwm_buffer_dirty_blocks[0] != 0;
+}
+
+bool IS31FL3733_update_pwm_block( uint8_t addr1, uint8_t addr2 )
+{
+    uint16_t dirty = g_pwm_buffer_dirty_blocks[0];
+    uint8_t block = 0;
+
+    if ( dirty ) {
+        while ( !( dirty & 1 ) ) {
+            dirty >>= 1;
+            block++;
+        }
+        // The page may have been switched since the last block
+        IS31FL3733_write_register( addr1, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5 );
+        IS31FL3733_write_register( addr1, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM );
+        if ( !IS31FL3733_write_pwm_buffer_range( addr1, g_pwm_buffer[0], block * 16, 16 ) ) {
+            return false;
+        }
+        g_pwm_buffer_dirty_blocks[0] &= ~( 1 << block );
     }
-    g_pwm_buffer_update_required = false;
+
+    g_pwm_buffer_update_required = g_pwm_buffer_dirty_blocks[0] != 0;
+    return g_pwm_buffer_update_required;
 }
 
 void IS31FL3733_update_led_control_registers( uint8_t addr1, uint8_t addr2 )
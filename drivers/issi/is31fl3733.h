@@ -22,6 +22,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "color.h"
 
 typedef struct is31_led {
   uint8_t driver:2;
@@ -35,9 +36,12 @@ extern const is31_led g_is31_leds[DRIVER_LED_TOTAL];
 void IS31FL3733_init( uint8_t addr );
 void IS31FL3733_write_register( uint8_t addr, uint8_t reg, uint8_t data );
 void IS31FL3733_write_pwm_buffer( uint8_t addr, uint8_t *pwm_buffer );
+bool IS31FL3733_write_pwm_buffer_range( uint8_t addr, uint8_t *pwm_buffer, uint8_t offset, uint8_t length );
 
 void IS31FL3733_set_color( int index, uint8_t red, uint8_t green, uint8_t blue );
 void IS31FL3733_set_color_all( uint8_t red, uint8_t green, uint8_t blue );
+// Sets every LED from an array of DRIVER_LED_TOTAL colors
+void IS31FL3733_set_color_buffer( const RGB *leds );
 
 void IS31FL3733_set_led_control_register( uint8_t index, bool red, bool green, bool blue );
 
@@ -46,6 +50,9 @@ void IS31FL3733_set_led_control_register( uint8_t index, bool red, bool green, b
 // Call this while idle (in between matrix scans).
 // If the buffer is dirty, it will update the driver with the buffer.
 void IS31FL3733_update_pwm_buffers( uint8_t addr1, uint8_t addr2 );
+// Sends only the lowest dirty PWM block, returns true while more are left.
+// A failed block stays dirty and also returns false, the next flush retries it.
+bool IS31FL3733_update_pwm_block( uint8_t addr1, uint8_t addr2 );
 void IS31FL3733_update_led_control_registers( uint8_t addr1, uint8_t addr2 );
 
 #define A_1  0x00
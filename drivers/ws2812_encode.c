@@ -0,0 +1,76 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ws2812_encode.h"
+#include <string.h>
+
+uint16_t ws2812_encode(const uint8_t *data, uint16_t length, uint8_t *buffer) {
+  uint8_t *out = buffer;
+
+  for (uint16_t i = 0; i < length; i++) {
+    uint8_t value = data[i];
+    // 100 for every bit, then the middle bit of each triplet set for the ones
+    uint32_t bits = 0x924924;
+
+    for (uint8_t bit = 0; bit < 8; bit++) {
+      if (value & (0x80 >> bit)) {
+        bits |= (uint32_t)0x400000 >> (bit * 3);
+      }
+    }
+
+    *out++ = bits >> 16;
+    *out++ = bits >> 8;
+    *out++ = bits;
+  }
+
+  memset(out, 0, WS2812_RESET_BYTES);
+  out += WS2812_RESET_BYTES;
+
+  return out - buffer;
+}
+
+void ws2812_frames_init(ws2812_frames_t *frames) {
+  frames->sending = WS2812_NO_BUFFER;
+  frames->ready = WS2812_NO_BUFFER;
+  frames->data_length[0] = 0;
+  frames->data_length[1] = 0;
+}
+
+uint8_t ws2812_frames_claim(ws2812_frames_t *frames, uint16_t *length) {
+  if (frames->ready != WS2812_NO_BUFFER) {
+    // never went out, the new frame has to carry its LEDs as well
+    if (frames->data_length[frames->ready] > *length) {
+      *length = frames->data_length[frames->ready];
+    }
+    frames->ready = WS2812_NO_BUFFER;
+  }
+  return frames->sending == 0 ? 1 : 0;
+}
+
+void ws2812_frames_ready(ws2812_frames_t *frames, uint8_t index, uint16_t length) {
+  frames->data_length[index] = length;
+  frames->ready = index;
+}
+
+uint8_t ws2812_frames_next(ws2812_frames_t *frames) {
+  frames->sending = frames->ready;
+  frames->ready = WS2812_NO_BUFFER;
+  return frames->sending;
+}
+
+void ws2812_frames_sent(ws2812_frames_t *frames) {
+  frames->sending = WS2812_NO_BUFFER;
+}
@@ -0,0 +1,72 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Encodes WS2812 data as an SPI bit stream, so a peripheral can send it with
+ * DMA instead of the CPU timing every bit.
+ *
+ * Each WS2812 bit takes three SPI bits: 0 is sent as 100 and 1 as 110. With
+ * the SPI clock at about 2.25 MHz that gives high times of 0.44 us and
+ * 0.89 us within a 1.33 us bit, as the WS2812B datasheet asks for. Every data
+ * byte therefore becomes three SPI bytes, MSB first.
+ */
+
+#define WS2812_SPI_BYTES_PER_BYTE 3
+
+// Low time after the data that latches it, at least 50 us
+#ifndef WS2812_RESET_BYTES
+  #define WS2812_RESET_BYTES 20
+#endif
+
+#define WS2812_ENCODED_SIZE(length) ((length) * WS2812_SPI_BYTES_PER_BYTE + WS2812_RESET_BYTES)
+
+// Encodes length bytes of data, in the order they go out on the wire, and
+// appends the reset time. Returns the number of bytes written to buffer,
+// which must hold WS2812_ENCODED_SIZE(length).
+uint16_t ws2812_encode(const uint8_t *data, uint16_t length, uint8_t *buffer);
+
+/* Hand-off of encoded frames between the caller and a sender that runs on
+ * its own, such as a thread feeding DMA. There are two buffers: one can be
+ * on the wire while the next frame is encoded into the other. All of these
+ * must be called with the platform lock held.
+ */
+
+#define WS2812_NO_BUFFER 0xFF
+
+typedef struct {
+  uint8_t sending;          // buffer on the wire, or WS2812_NO_BUFFER
+  uint8_t ready;            // buffer waiting to be sent, or WS2812_NO_BUFFER
+  uint16_t data_length[2];  // bytes of LED data each buffer was encoded from
+} ws2812_frames_t;
+
+void ws2812_frames_init(ws2812_frames_t *frames);
+
+// Takes back a frame that is ready but was not picked up yet, and returns
+// the buffer to encode the next frame into. Raises length to cover the
+// frame taken back, so LEDs that only it would have updated still are.
+uint8_t ws2812_frames_claim(ws2812_frames_t *frames, uint16_t *length);
+
+// Hands over a buffer encoded from length bytes of LED data.
+void ws2812_frames_ready(ws2812_frames_t *frames, uint8_t index, uint16_t length);
+
+// For the sender: returns the buffer to put on the wire next, or
+// WS2812_NO_BUFFER, and ws2812_frames_sent() once it is done with it.
+uint8_t ws2812_frames_next(ws2812_frames_t *frames);
+void ws2812_frames_sent(ws2812_frames_t *frames);
@@ -19,69 +19,119 @@
 #include "led_tables.h"
 #include "progmem.h"
 
-RGB hsv_to_rgb( HSV hsv )
+// h / 43 for every 8-bit hue, as a multiply and shift
+#define HUE_REGION(h) ( ( (uint16_t)(h) * 191 ) >> 13 )
+
+// The hue's sector picks which channel is v, which is p and which is the
+// one that changes across the sector (q or t).
+static inline RGB hsv_to_rgb_sector( uint8_t region, uint8_t v, uint8_t p, uint8_t x )
 {
 	RGB rgb;
-	uint8_t region, p, q, t;
-	uint16_t h, s, v, remainder;
-
-	if ( hsv.s == 0 )
-	{
-		rgb.r = hsv.v;
-		rgb.g = hsv.v;
-		rgb.b = hsv.v;
-		return rgb;
-	}
-
-	h = hsv.h;
-	s = hsv.s;
-	v = hsv.v;
-
-	region = h / 43;
-	remainder = (h - (region * 43)) * 6;
-
-	p = (v * (255 - s)) >> 8;
-	q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-	t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
 
 	switch ( region )
 	{
 		case 0:
 			rgb.r = v;
-			rgb.g = t;
+			rgb.g = x;
 			rgb.b = p;
 			break;
 		case 1:
-			rgb.r = q;
+			rgb.r = x;
 			rgb.g = v;
 			rgb.b = p;
 			break;
 		case 2:
 			rgb.r = p;
 			rgb.g = v;
-			rgb.b = t;
+			rgb.b = x;
 			break;
 		case 3:
 			rgb.r = p;
-			rgb.g = q;
+			rgb.g = x;
 			rgb.b = v;
 			break;
 		case 4:
-			rgb.r = t;
+			rgb.r = x;
 			rgb.g = p;
 			rgb.b = v;
 			break;
 		default:
 			rgb.r = v;
 			rgb.g = p;
-			rgb.b = q;
+			rgb.b = x;
 			break;
 	}
 
-	rgb.r = pgm_read_byte( &CIE1931_CURVE[rgb.r] );
-	rgb.g = pgm_read_byte( &CIE1931_CURVE[rgb.g] );
-	rgb.b = pgm_read_byte( &CIE1931_CURVE[rgb.b] );
-
 	return rgb;
 }
 
+// The changing channel: q in the odd sectors, t in the even ones
+static inline uint8_t hsv_to_rgb_ramp( uint8_t h, uint8_t region, uint16_t s, uint16_t v )
+{
+	uint16_t remainder = ( h - ( region * 43 ) ) * 6;
+
+	if ( !( region & 1 ) )
+	{
+		remainder = 255 - remainder;
+	}
+	return ( v * ( 255 - ( ( s * remainder ) >> 8 ) ) ) >> 8;
+}
+
+RGB hsv_to_rgb( HSV hsv )
+{
+	RGB rgb;
+	uint8_t region, p, x;
+
+	if ( hsv.s == 0 )
+	{
+		rgb.r = hsv.v;
+		rgb.g = hsv.v;
+		rgb.b = hsv.v;
+		return rgb;
+	}
+
+	region = HUE_REGION( hsv.h );
+	p = ( hsv.v * ( 255 - hsv.s ) ) >> 8;
+	x = hsv_to_rgb_ramp( hsv.h, region, hsv.s, hsv.v );
+
+	return hsv_to_rgb_sector( region,
+		pgm_read_byte( &CIE1931_CURVE[hsv.v] ),
+		pgm_read_byte( &CIE1931_CURVE[p] ),
+		pgm_read_byte( &CIE1931_CURVE[x] ) );
+}
+
+void hsv_to_rgb_buffer( const HSV *hsv, RGB *rgb, uint16_t count )
+{
+	// Effects mostly vary the hue and keep saturation and brightness, so the
+	// corrected v and p carry over from one LED to the next and only the
+	// changing channel needs a trip through the gamma table.
+	uint8_t s = 0, v = 0, gamma_v = 0, gamma_p = 0;
+	bool cached = false;
+
+	for ( uint16_t i = 0; i < count; i++ )
+	{
+		HSV in = hsv[i];
+
+		if ( in.s == 0 )
+		{
+			rgb[i].r = in.v;
+			rgb[i].g = in.v;
+			rgb[i].b = in.v;
+			continue;
+		}
+
+		if ( !cached || in.s != s || in.v != v )
+		{
+			s = in.s;
+			v = in.v;
+			gamma_v = pgm_read_byte( &CIE1931_CURVE[v] );
+			gamma_p = pgm_read_byte( &CIE1931_CURVE[( v * ( 255 - s ) ) >> 8] );
+			cached = true;
+		}
+
+		uint8_t region = HUE_REGION( in.h );
+		uint8_t x = hsv_to_rgb_ramp( in.h, region, s, v );
+
+		rgb[i] = hsv_to_rgb_sector( region, gamma_v, gamma_p, pgm_read_byte( &CIE1931_CURVE[x] ) );
+	}
+}
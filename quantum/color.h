@@ -52,4 +52,8 @@ typedef struct PACKED
 
 RGB hsv_to_rgb( HSV hsv );
 
+// Converts count colors from hsv into rgb, the same as calling hsv_to_rgb()
+// on each, with fewer gamma table reads when neighbours share s and v.
+void hsv_to_rgb_buffer( const HSV *hsv, RGB *rgb, uint16_t count );
+
 #endif // COLOR_H
@@ -130,6 +130,13 @@ uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key)
 
 
 
+// Offset of the start of each macro string within the macro buffer,
+// so sending a macro does not have to skip N null terminators first.
+// Built lazily on the first send after the buffer changes.
+#define DYNAMIC_KEYMAP_MACRO_OFFSET_NONE 0xFFFF
+static uint16_t macro_offsets[DYNAMIC_KEYMAP_MACRO_COUNT];
+static bool macro_offsets_valid = false;
+
 uint8_t dynamic_keymap_macro_get_count(void)
 {
 	return DYNAMIC_KEYMAP_MACRO_COUNT;
@@ -166,6 +173,7 @@ void dynamic_keymap_macro_set_buffer( uint16_t offset, uint16_t size, uint8_t *d
 		source++;
 		target++;
 	}
+	macro_offsets_valid = false;
 }
 
 void dynamic_keymap_macro_reset(void)
@@ -176,6 +184,33 @@ void dynamic_keymap_macro_reset(void)
 		eeprom_update_byte(p, 0);
 		++p;
 	}
+	macro_offsets_valid = false;
+}
+
+void dynamic_keymap_macro_build_index(void)
+{
+	// Skip N null characters to find the start of the Nth macro.
+	// If we run past the end of the buffer, then the buffer
+	// contents are garbage, i.e. there were not DYNAMIC_KEYMAP_MACRO_COUNT
+	// nulls in the buffer, and the remaining macros are left unset.
+	void *p = (void*)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
+	void *end = (void*)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR+DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
+	uint8_t id = 0;
+	macro_offsets[id] = 0;
+	while ( p != end && id < DYNAMIC_KEYMAP_MACRO_COUNT - 1 ) {
+		if ( eeprom_read_byte(p++) == 0 && p != end ) {
+			macro_offsets[++id] = (uint16_t)(p - (void*)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR));
+		}
+	}
+	while ( ++id < DYNAMIC_KEYMAP_MACRO_COUNT ) {
+		macro_offsets[id] = DYNAMIC_KEYMAP_MACRO_OFFSET_NONE;
+	}
+	macro_offsets_valid = true;
+}
+
+static uint8_t dynamic_keymap_macro_read_byte(const char *p)
+{
+	return eeprom_read_byte((const uint8_t*)p);
 }
 
 void dynamic_keymap_macro_send( uint8_t id )
@@ -193,37 +228,18 @@ void dynamic_keymap_macro_send( uint8_t id )
 		return;
 	}
 
-	// Skip N null characters
-	// p will then point to the Nth macro
-	p = (void*)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR);
-	void *end = (void*)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR+DYNAMIC_KEYMAP_MACRO_EEPROM_SIZE);
-	while ( id > 0 ) {
-		// If we are past the end of the buffer, then the buffer
-		// contents are garbage, i.e. there were not DYNAMIC_KEYMAP_MACRO_COUNT
-		// nulls in the buffer.
-		if ( p == end ) {
-			return;
-		}
-		if ( eeprom_read_byte(p) == 0 ) {
-			--id;
-		}
-		++p;
+	if ( !macro_offsets_valid ) {
+		dynamic_keymap_macro_build_index();
+	}
+	if ( macro_offsets[id] == DYNAMIC_KEYMAP_MACRO_OFFSET_NONE ) {
+		return;
 	}
 
-	// Send the macro string one char at a time
-	// by making temporary 1 char strings
-	char data[2] = { 0, 0 };
+	// Stream the macro string straight out of EEPROM.
 	// We already checked there was a null at the end of
 	// the buffer, so this cannot go past the end
-	while ( 1 ) {
-		data[0] = eeprom_read_byte(p);
-		// Stop at the null terminator of this macro string
-		if ( data[0] == 0 ) {
-			break;
-		}
-		send_string(data);
-		++p;
-	}
+	p = (void*)(DYNAMIC_KEYMAP_MACRO_EEPROM_ADDR+macro_offsets[id]);
+	send_string_with_reader((const char*)p, 0, dynamic_keymap_macro_read_byte);
 }
 
 #endif // DYNAMIC_KEYMAP_ENABLE
@@ -58,6 +58,10 @@ uint16_t dynamic_keymap_macro_get_buffer_size(void);
 void dynamic_keymap_macro_get_buffer( uint16_t offset, uint16_t size, uint8_t *data );
 void dynamic_keymap_macro_set_buffer( uint16_t offset, uint16_t size, uint8_t *data );
 void dynamic_keymap_macro_reset(void);
+// Rebuilds the table of macro start offsets. This is done automatically
+// on the first send after the buffer is changed through the functions above,
+// keyboards writing the macro EEPROM directly should call it afterwards.
+void dynamic_keymap_macro_build_index(void);
 
 void dynamic_keymap_macro_send( uint8_t id );
 
@@ -0,0 +1,83 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fixed_math.h"
+#include "progmem.h"
+
+// First quarter of a sine wave, sin(i * pi / 128) * 32767
+static const int16_t SIN_QUARTER[65] PROGMEM = {
+        0,   804,  1608,  2410,  3212,  4011,  4808,  5602,
+     6393,  7179,  7962,  8739,  9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767
+};
+
+int16_t sin16(uint8_t theta) {
+    uint8_t quarter = theta & 0x3F;
+    if (theta & 0x40) {
+        quarter = 64 - quarter;
+    }
+    int16_t value = pgm_read_word(&SIN_QUARTER[quarter]);
+    return (theta & 0x80) ? -value : value;
+}
+
+uint8_t atan2_8(int16_t y, int16_t x) {
+    uint16_t ax = x < 0 ? -(int32_t)x : x;
+    uint16_t ay = y < 0 ? -(int32_t)y : y;
+    if (ax == 0 && ay == 0) {
+        return 0;
+    }
+
+    // atan(r) for r = min / max in 0..1, as an angle in 0..32,
+    // using atan(r) ~= pi/4 * r + 0.273 * r * (1 - r)
+    uint16_t r = ax > ay ? ((uint32_t)ay << 8) / ax : ((uint32_t)ax << 8) / ay;
+    uint8_t angle = ((uint32_t)r * (32 * 256 + 11 * (256 - r)) + 0x8000) >> 16;
+
+    if (ay > ax) {
+        angle = 64 - angle;
+    }
+    if (x < 0) {
+        angle = 128 - angle;
+    }
+    if (y < 0) {
+        angle = -angle;
+    }
+    return angle;
+}
+
+uint16_t sqrt32(uint32_t x) {
+    uint32_t result = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit) {
+        if (x >= result + bit) {
+            x -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
@@ -0,0 +1,64 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FIXED_MATH_H
+#define FIXED_MATH_H
+
+#include <stdint.h>
+
+/* Integer replacements for the libm functions used by the lighting effects,
+ * which are soft-float on AVR and Cortex-M0.
+ *
+ * Angles are 8-bit, 256 steps make a full turn, so sin16(64) is sin(pi/2).
+ */
+
+// Returns sin(theta) scaled to -32767..32767
+int16_t sin16(uint8_t theta);
+
+static inline int16_t cos16(uint8_t theta) {
+    return sin16(theta + 64);
+}
+
+// Returns sin(theta) scaled to 0..255, with 128 as zero
+static inline uint8_t sin8(uint8_t theta) {
+    return (sin16(theta) >> 8) + 128;
+}
+
+static inline uint8_t cos8(uint8_t theta) {
+    return (cos16(theta) >> 8) + 128;
+}
+
+// Returns i * scale / 256
+static inline uint8_t scale8(uint8_t i, uint8_t scale) {
+    return ((uint16_t)i * scale) >> 8;
+}
+
+static inline uint16_t scale16by8(uint16_t i, uint8_t scale) {
+    return ((uint32_t)i * scale) >> 8;
+}
+
+// Linear interpolation from a (frac = 0) towards b (frac = 256)
+static inline uint16_t lerp16by8(uint16_t a, uint16_t b, uint8_t frac) {
+    return a + (((int32_t)b - a) * frac >> 8);
+}
+
+// Returns the angle of the vector (x, y), within about one step
+uint8_t atan2_8(int16_t y, int16_t x);
+
+// Returns floor(sqrt(x))
+uint16_t sqrt32(uint32_t x);
+
+#endif
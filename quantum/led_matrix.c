@@ -96,17 +96,36 @@ void eeconfig_debug_led_matrix(void) {
 uint8_t g_last_led_hit[LED_HITS_TO_REMEMBER] = {255};
 uint8_t g_last_led_count = 0;
 
+// Built from g_leds at init: the first LED under each key, chained through
+// g_key_next_led to the rest of the LEDs under that key
+#define NO_LED 255
+static uint8_t g_key_first_led[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t g_key_next_led[LED_DRIVER_LED_COUNT];
+
+static void build_row_column_to_led_map(void) {
+    memset(g_key_first_led, NO_LED, sizeof(g_key_first_led));
+    // Walk backwards so the LEDs of each key are chained in index order
+    for (uint8_t i = LED_DRIVER_LED_COUNT; i-- > 0;) {
+        uint8_t row = g_leds[i].matrix_co.row;
+        uint8_t col = g_leds[i].matrix_co.col;
+        g_key_next_led[i] = NO_LED;
+        if (row < MATRIX_ROWS && col < MATRIX_COLS) {
+            g_key_next_led[i] = g_key_first_led[row][col];
+            g_key_first_led[row][col] = i;
+        }
+    }
+}
+
 void map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i, uint8_t *led_count) {
-    led_matrix led;
     *led_count = 0;
+    // TICK and events synthesized by user code use positions like 255, 255
+    if (row >= MATRIX_ROWS || column >= MATRIX_COLS) {
+        return;
+    }
 
-    for (uint8_t i = 0; i < LED_DRIVER_LED_COUNT; i++) {
-        // map_index_to_led(i, &led);
-        led = g_leds[i];
-        if (row == led.matrix_co.row && column == led.matrix_co.col) {
-            led_i[*led_count] = i;
-            (*led_count)++;
-        }
+    for (uint8_t i = g_key_first_led[row][column]; i != NO_LED; i = g_key_next_led[i]) {
+        led_i[*led_count] = i;
+        (*led_count)++;
     }
 }
 
@@ -244,6 +263,8 @@ void led_matrix_indicators_user(void) {}
 void led_matrix_init(void) {
     led_matrix_driver.init();
 
+    build_row_column_to_led_map();
+
     // Wait half a second for the driver to finish initializing
     wait_ms(500);
 
@@ -17,6 +17,7 @@
 #ifdef AUTO_SHIFT_ENABLE
 
 #include <stdio.h>
+#include <string.h>
 
 #include "process_auto_shift.h"
 
@@ -30,9 +31,29 @@
   unregister_code(key); \
   unregister_code(mod)
 
-uint16_t autoshift_time = 0;
 uint16_t autoshift_timeout = AUTO_SHIFT_TIMEOUT;
-uint16_t autoshift_lastkey = KC_NO;
+
+// Keys that are held or waiting to be sent, in the order they were pressed.
+// A key is decided (shifted or not) when it's released or its timeout
+// passes, and sent as soon as every key pressed before it has been sent,
+// so rolled key presses come out in order without waiting for each other.
+typedef struct {
+  uint8_t keycode;
+  bool released;
+  bool decided;
+  bool shifted;
+  bool sent;
+  uint16_t time;
+  uint16_t timeout;
+} autoshift_key_t;
+
+static autoshift_key_t autoshift_keys[AUTO_SHIFT_QUEUE_SIZE];
+static uint8_t autoshift_key_count = 0;
+
+// Keys that were already sent but dropped from the queue to make room
+// while still held, so their release isn't taken for someone else's
+static uint8_t autoshift_forgotten[AUTO_SHIFT_QUEUE_SIZE];
+static uint8_t autoshift_forgotten_count = 0;
 
 void autoshift_timer_report(void) {
   char display[8];
@@ -42,28 +63,125 @@ void autoshift_timer_report(void) {
   send_string((const char *)display);
 }
 
+#ifdef AUTO_SHIFT_KEY_TIMEOUT_COUNT
+static uint16_t autoshift_get_timeout(uint8_t keycode) {
+  for (uint8_t i = 0; i < AUTO_SHIFT_KEY_TIMEOUT_COUNT; i++) {
+    if (pgm_read_byte(&autoshift_key_timeouts[i].keycode) == keycode) {
+      return pgm_read_word(&autoshift_key_timeouts[i].timeout);
+    }
+  }
+  return autoshift_timeout;
+}
+#else
+  #define autoshift_get_timeout(keycode) autoshift_timeout
+#endif
+
+static void autoshift_decide(autoshift_key_t *key) {
+  if (!key->decided) {
+    key->decided = true;
+    key->shifted = timer_elapsed(key->time) > key->timeout;
+  }
+}
+
+static void autoshift_send(void) {
+  uint8_t kept = 0;
+  bool blocked = false;
+
+  for (uint8_t i = 0; i < autoshift_key_count; i++) {
+    autoshift_key_t *key = &autoshift_keys[i];
+    if (!key->decided) {
+      blocked = true;
+    }
+    if (!blocked && !key->sent) {
+      if (key->shifted) {
+        register_code(KC_LSFT);
+      }
+      TAP(key->keycode);
+      if (key->shifted) {
+        unregister_code(KC_LSFT);
+      }
+      key->sent = true;
+    }
+    if (!(key->sent && key->released)) {
+      autoshift_keys[kept++] = *key;
+    }
+  }
+  autoshift_key_count = kept;
+}
+
+static void autoshift_forget(uint8_t index) {
+  if (autoshift_forgotten_count == AUTO_SHIFT_QUEUE_SIZE) {
+    memmove(autoshift_forgotten, autoshift_forgotten + 1, --autoshift_forgotten_count);
+  }
+  autoshift_forgotten[autoshift_forgotten_count++] = autoshift_keys[index].keycode;
+
+  autoshift_key_count--;
+  memmove(autoshift_keys + index, autoshift_keys + index + 1, (autoshift_key_count - index) * sizeof(autoshift_key_t));
+}
+
 void autoshift_on(uint16_t keycode) {
-  autoshift_time = timer_read();
-  autoshift_lastkey = keycode;
+  if (autoshift_key_count == AUTO_SHIFT_QUEUE_SIZE) {
+    // Make room by forgetting the oldest key that is only being held,
+    // or by deciding the oldest pending key early
+    uint8_t i = 0;
+    while (i < autoshift_key_count && !autoshift_keys[i].sent) {
+      i++;
+    }
+    if (i < autoshift_key_count) {
+      autoshift_forget(i);
+    } else {
+      autoshift_decide(&autoshift_keys[0]);
+    }
+    autoshift_send();
+  }
+
+  autoshift_keys[autoshift_key_count++] = (autoshift_key_t){
+    .keycode = keycode,
+    .time = timer_read(),
+    .timeout = autoshift_get_timeout(keycode),
+  };
 }
 
 void autoshift_flush(void) {
-  if (autoshift_lastkey != KC_NO) {
-    uint16_t elapsed = timer_elapsed(autoshift_time);
+  for (uint8_t i = 0; i < autoshift_key_count; i++) {
+    autoshift_decide(&autoshift_keys[i]);
+  }
+  autoshift_send();
+}
 
-    if (elapsed > autoshift_timeout) {
-      register_code(KC_LSFT);
+static void autoshift_release(uint16_t keycode) {
+  for (uint8_t i = 0; i < autoshift_key_count; i++) {
+    autoshift_key_t *key = &autoshift_keys[i];
+    if (key->keycode == keycode && !key->released) {
+      key->released = true;
+      autoshift_decide(key);
+      autoshift_send();
+      return;
     }
+  }
+  for (uint8_t i = 0; i < autoshift_forgotten_count; i++) {
+    if (autoshift_forgotten[i] == keycode) {
+      autoshift_forgotten_count--;
+      memmove(autoshift_forgotten + i, autoshift_forgotten + i + 1, autoshift_forgotten_count - i);
+      return;
+    }
+  }
+  // Not one of ours, decide everything like any other key does
+  autoshift_flush();
+}
 
-    register_code(autoshift_lastkey);
-    unregister_code(autoshift_lastkey);
+void matrix_scan_auto_shift(void) {
+  bool timed_out = false;
 
-    if (elapsed > autoshift_timeout) {
-      unregister_code(KC_LSFT);
+  for (uint8_t i = 0; i < autoshift_key_count; i++) {
+    autoshift_key_t *key = &autoshift_keys[i];
+    if (!key->decided && timer_elapsed(key->time) > key->timeout) {
+      autoshift_decide(key);
+      timed_out = true;
     }
-
-    autoshift_time = 0;
-    autoshift_lastkey = KC_NO;
+  }
+  if (timed_out) {
+    autoshift_send();
   }
 }
 
@@ -177,7 +295,6 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
       case KC_NONUS_HASH:
 #endif
 
-        autoshift_flush();
         if (!autoshift_enabled) return true;
 
 #ifndef AUTO_SHIFT_MODIFIERS
@@ -189,6 +306,7 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
         );
 
         if (any_mod_pressed) {
+          autoshift_flush();
           return true;
         }
 #endif
@@ -201,7 +319,7 @@ bool process_auto_shift(uint16_t keycode, keyrecord_t *record) {
         return true;
     }
   } else {
-    autoshift_flush();
+    autoshift_release(keycode);
   }
 
   return true;
@@ -23,7 +23,22 @@
   #define AUTO_SHIFT_TIMEOUT 175
 #endif
 
+// How many rolled keys can be held or waiting to be sent at once
+#ifndef AUTO_SHIFT_QUEUE_SIZE
+  #define AUTO_SHIFT_QUEUE_SIZE 4
+#endif
+
+#ifdef AUTO_SHIFT_KEY_TIMEOUT_COUNT
+typedef struct {
+  uint8_t keycode;
+  uint16_t timeout;
+} autoshift_key_timeout_t;
+
+extern const autoshift_key_timeout_t autoshift_key_timeouts[AUTO_SHIFT_KEY_TIMEOUT_COUNT];
+#endif
+
 bool process_auto_shift(uint16_t keycode, keyrecord_t *record);
+void matrix_scan_auto_shift(void);
 
 void autoshift_enable(void);
 void autoshift_disable(void);
@@ -35,6 +35,106 @@ uint16_t leader_time = 0;
 uint16_t leader_sequence[5] = {0, 0, 0, 0, 0};
 uint8_t leader_sequence_size = 0;
 
+#ifdef LEADER_SEQUENCE_COUNT
+__attribute__ ((weak))
+void process_leader_sequence(uint8_t sequence_index) {}
+
+// The sequences that still match the keys typed so far are always a
+// contiguous range of leader_order, which lists the table sorted by keycode
+// so sequences sharing a prefix are next to each other. Each key narrows the
+// range, so the table is walked like a trie without having to compare every
+// sequence.
+static uint8_t leader_range_start = 0;
+static uint8_t leader_range_end = 0;
+static uint8_t leader_order[LEADER_SEQUENCE_COUNT];
+static bool leader_order_sorted = false;
+
+#if defined(__AVR__)
+  #define LEADER_SEQUENCE_KEYS(i) ((const uint16_t *)pgm_read_word(&leader_sequences[i]))
+#else
+  #define LEADER_SEQUENCE_KEYS(i) (leader_sequences[i])
+#endif
+
+static inline uint16_t leader_sequence_key(uint8_t index, uint8_t position) {
+  return pgm_read_word(&LEADER_SEQUENCE_KEYS(index)[position]);
+}
+
+// The key at position of the sequence at rank in leader_order
+static inline uint16_t leader_sorted_key(uint8_t rank, uint8_t position) {
+  return leader_sequence_key(leader_order[rank], position);
+}
+
+static bool leader_sequence_less(uint8_t a, uint8_t b) {
+  for (uint8_t position = 0;; position++) {
+    uint16_t key_a = leader_sequence_key(a, position);
+    uint16_t key_b = leader_sequence_key(b, position);
+    if (key_a != key_b) {
+      return key_a < key_b;
+    }
+    if (key_a == LEADER_SEQ_END) {
+      return false;
+    }
+  }
+}
+
+// Insertion sort, once, so the keymap can list the sequences in any order
+static void leader_sort_sequences(void) {
+  for (uint8_t i = 0; i < LEADER_SEQUENCE_COUNT; i++) {
+    uint8_t j = i;
+    for (; j > 0 && leader_sequence_less(i, leader_order[j - 1]); j--) {
+      leader_order[j] = leader_order[j - 1];
+    }
+    leader_order[j] = i;
+  }
+  leader_order_sorted = true;
+}
+
+static void leader_finish(int16_t sequence_index) {
+  leading = false;
+  if (sequence_index >= 0) {
+    process_leader_sequence(sequence_index);
+  }
+  leader_end();
+}
+
+// Returns the sequence that ends exactly at the current key, or -1
+static int16_t leader_complete_sequence(void) {
+  for (uint8_t i = leader_range_start; i < leader_range_end; i++) {
+    if (leader_sorted_key(i, leader_sequence_size) == LEADER_SEQ_END) {
+      return leader_order[i];
+    }
+  }
+  return -1;
+}
+
+static void leader_advance(uint16_t keycode, uint8_t position) {
+  uint8_t i = leader_range_start;
+  while (i < leader_range_end && leader_sorted_key(i, position) != keycode) {
+    i++;
+  }
+  leader_range_start = i;
+  while (i < leader_range_end && leader_sorted_key(i, position) == keycode) {
+    i++;
+  }
+  leader_range_end = i;
+
+  if (leader_range_start == leader_range_end) {
+    // Nothing can match anymore, no need to wait for the timeout
+    leader_finish(-1);
+  } else if (leader_range_end - leader_range_start == 1 &&
+             leader_sorted_key(leader_range_start, position + 1) == LEADER_SEQ_END) {
+    // A unique match, no longer sequence can follow
+    leader_finish(leader_order[leader_range_start]);
+  }
+}
+
+void matrix_scan_leader(void) {
+  if (leading && timer_elapsed(leader_time) > LEADER_TIMEOUT) {
+    leader_finish(leader_complete_sequence());
+  }
+}
+#endif
+
 void qk_leader_start(void) {
   if (leading) { return; }
   leader_start();
@@ -46,6 +146,13 @@ void qk_leader_start(void) {
   leader_sequence[2] = 0;
   leader_sequence[3] = 0;
   leader_sequence[4] = 0;
+#ifdef LEADER_SEQUENCE_COUNT
+  if (!leader_order_sorted) {
+    leader_sort_sequences();
+  }
+  leader_range_start = 0;
+  leader_range_end = LEADER_SEQUENCE_COUNT;
+#endif
 }
 
 bool process_leader(uint16_t keycode, keyrecord_t *record) {
@@ -58,8 +165,15 @@ bool process_leader(uint16_t keycode, keyrecord_t *record) {
           keycode = keycode & 0xFF;
         }
 #endif // LEADER_KEY_STRICT_KEY_PROCESSING
-        leader_sequence[leader_sequence_size] = keycode;
-        leader_sequence_size++;
+        if (leader_sequence_size < sizeof(leader_sequence) / sizeof(leader_sequence[0])) {
+          leader_sequence[leader_sequence_size] = keycode;
+        }
+#ifdef LEADER_SEQUENCE_COUNT
+        leader_advance(keycode, leader_sequence_size);
+#endif
+        if (leader_sequence_size < 0xFF) {
+          leader_sequence_size++;
+        }
 #ifdef LEADER_PER_KEY_TIMING
         leader_time = timer_read();
 #endif
@@ -26,6 +26,16 @@ void leader_start(void);
 void leader_end(void);
 void qk_leader_start(void);
 
+#ifdef LEADER_SEQUENCE_COUNT
+// Each sequence is a LEADER_SEQ_END terminated array of keycodes in PROGMEM,
+// listed in leader_sequences in any order.
+#define LEADER_SEQ_END 0
+extern const uint16_t * const leader_sequences[LEADER_SEQUENCE_COUNT];
+
+void process_leader_sequence(uint8_t sequence_index);
+void matrix_scan_leader(void);
+#endif
+
 #define SEQ_ONE_KEY(key) if (leader_sequence[0] == (key) && leader_sequence[1] == 0 && leader_sequence[2] == 0 && leader_sequence[3] == 0 && leader_sequence[4] == 0)
 #define SEQ_TWO_KEYS(key1, key2) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == 0 && leader_sequence[3] == 0 && leader_sequence[4] == 0)
 #define SEQ_THREE_KEYS(key1, key2, key3) if (leader_sequence[0] == (key1) && leader_sequence[1] == (key2) && leader_sequence[2] == (key3) && leader_sequence[3] == 0 && leader_sequence[4] == 0)
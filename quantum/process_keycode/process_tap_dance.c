@@ -25,7 +25,28 @@ uint8_t get_oneshot_mods(void);
 #endif
 
 static uint16_t last_td;
-static int8_t highest_td = -1;
+static int16_t highest_td = -1;
+
+// One bit per tap dance that is in progress (count > 0), so the scan and the
+// interrupt check only visit those dances instead of every one that is defined.
+static uint8_t active_td[(QK_TAP_DANCE_MAX - QK_TAP_DANCE + 1) / 8];
+static uint8_t active_td_count = 0;
+
+static inline void tap_dance_set_active(uint8_t idx) {
+  uint8_t mask = 1 << (idx & 7);
+  if (!(active_td[idx >> 3] & mask)) {
+    active_td[idx >> 3] |= mask;
+    active_td_count++;
+  }
+}
+
+static inline void tap_dance_clear_active(uint8_t idx) {
+  uint8_t mask = 1 << (idx & 7);
+  if (active_td[idx >> 3] & mask) {
+    active_td[idx >> 3] &= ~mask;
+    active_td_count--;
+  }
+}
 
 void qk_tap_dance_pair_on_each_tap (qk_tap_dance_state_t *state, void *user_data) {
   qk_tap_dance_pair_t *pair = (qk_tap_dance_pair_t *)user_data;
@@ -122,12 +143,15 @@ void preprocess_tap_dance(uint16_t keycode, keyrecord_t *record) {
   if (!record->event.pressed)
     return;
 
-  if (highest_td == -1)
+  if (!active_td_count)
     return;
 
-  for (int i = 0; i <= highest_td; i++) {
-    action = &tap_dance_actions[i];
-    if (action->state.count) {
+  for (uint8_t byte = 0; byte <= (highest_td >> 3); byte++) {
+    uint8_t bits = active_td[byte];
+    for (uint8_t i = byte << 3; bits; bits >>= 1, i++) {
+      if (!(bits & 1))
+        continue;
+      action = &tap_dance_actions[i];
       if (keycode == action->state.keycode && keycode == last_td)
         continue;
       action->state.interrupted = true;
@@ -152,6 +176,7 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
     if (record->event.pressed) {
       action->state.keycode = keycode;
       action->state.count++;
+      tap_dance_set_active(idx);
       action->state.timer = timer_read();
 #ifndef NO_ACTION_ONESHOT
       action->state.oneshot_mods = get_oneshot_mods();
@@ -178,21 +203,26 @@ bool process_tap_dance(uint16_t keycode, keyrecord_t *record) {
 
 
 void matrix_scan_tap_dance () {
-  if (highest_td == -1)
+  if (!active_td_count)
     return;
   uint16_t tap_user_defined;
 
-  for (uint8_t i = 0; i <= highest_td; i++) {
-    qk_tap_dance_action_t *action = &tap_dance_actions[i];
-    if(action->custom_tapping_term > 0 ) {
-      tap_user_defined = action->custom_tapping_term;
-    }
-    else{
-      tap_user_defined = TAPPING_TERM;
-    }
-    if (action->state.count && timer_elapsed (action->state.timer) > tap_user_defined) {
-      process_tap_dance_action_on_dance_finished (action);
-      reset_tap_dance (&action->state);
+  for (uint8_t byte = 0; byte <= (highest_td >> 3); byte++) {
+    uint8_t bits = active_td[byte];
+    for (uint8_t i = byte << 3; bits; bits >>= 1, i++) {
+      if (!(bits & 1))
+        continue;
+      qk_tap_dance_action_t *action = &tap_dance_actions[i];
+      if(action->custom_tapping_term > 0 ) {
+        tap_user_defined = action->custom_tapping_term;
+      }
+      else{
+        tap_user_defined = TAPPING_TERM;
+      }
+      if (action->state.count && timer_elapsed (action->state.timer) > tap_user_defined) {
+        process_tap_dance_action_on_dance_finished (action);
+        reset_tap_dance (&action->state);
+      }
     }
   }
 }
@@ -212,4 +242,5 @@ void reset_tap_dance (qk_tap_dance_state_t *state) {
   state->finished = false;
   state->interrupting_keycode = 0;
   last_td = 0;
+  tap_dance_clear_active(state->keycode - QK_TAP_DANCE);
 }
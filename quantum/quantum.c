@@ -55,6 +55,10 @@ extern backlight_config_t backlight_config;
 #include "encoder.h"
 #endif
 
+#ifdef I2C_QUEUE_ENABLE
+#include "i2c_queue.h"
+#endif
+
 #ifdef AUDIO_ENABLE
   #ifndef GOODBYE_SONG
     #define GOODBYE_SONG SONG(GOODBYE_SOUND)
@@ -881,56 +885,135 @@ void send_string_P(const char *str) {
   send_string_with_delay_P(str, 0);
 }
 
+static uint8_t send_string_read_byte(const char *str) {
+  return *str;
+}
+
+static uint8_t send_string_read_byte_P(const char *str) {
+  return pgm_read_byte(str);
+}
+
 void send_string_with_delay(const char *str, uint8_t interval) {
-    while (1) {
-        char ascii_code = *str;
-        if (!ascii_code) break;
-        if (ascii_code == 1) {
-          // tap
-          uint8_t keycode = *(++str);
-          register_code(keycode);
-          unregister_code(keycode);
-        } else if (ascii_code == 2) {
-          // down
-          uint8_t keycode = *(++str);
-          register_code(keycode);
-        } else if (ascii_code == 3) {
-          // up
-          uint8_t keycode = *(++str);
-          unregister_code(keycode);
-        } else {
-          send_char(ascii_code);
-        }
-        ++str;
-        // interval
-        { uint8_t ms = interval; while (ms--) wait_ms(1); }
-    }
+  send_string_with_reader(str, interval, send_string_read_byte);
 }
 
 void send_string_with_delay_P(const char *str, uint8_t interval) {
+  send_string_with_reader(str, interval, send_string_read_byte_P);
+}
+
+#ifdef SEND_STRING_BATCHED
+#ifndef SEND_STRING_BATCH_SIZE
+  #define SEND_STRING_BATCH_SIZE KEYBOARD_REPORT_KEYS
+#endif
+
+// Consecutive characters are pressed together in a single report and
+// released together in the next one. A batch ends when a character repeats,
+// the shift state changes, or the report is full. NKRO reports are bitmaps,
+// which the host reads in keycode order, so there the keycodes of a batch
+// must also be increasing to keep the typed order.
+static struct {
+  uint8_t keys[SEND_STRING_BATCH_SIZE];
+  uint8_t count;
+  uint8_t size;
+  bool shifted;
+} send_string_batch;
+
+static void send_string_batch_flush(void) {
+  if (!send_string_batch.count) return;
+  send_keyboard_report();
+  for (uint8_t i = 0; i < send_string_batch.count; i++) {
+    del_key(send_string_batch.keys[i]);
+  }
+  send_keyboard_report();
+  if (send_string_batch.shifted) {
+    unregister_code(KC_LSFT);
+  }
+  send_string_batch.count = 0;
+}
+
+static bool send_string_batch_accepts(uint8_t keycode, bool shifted) {
+  if (shifted != send_string_batch.shifted || send_string_batch.count >= send_string_batch.size) {
+    return false;
+  }
+#ifdef NKRO_ENABLE
+  if (keyboard_protocol && keymap_config.nkro) {
+    return keycode > send_string_batch.keys[send_string_batch.count - 1];
+  }
+#endif
+  for (uint8_t i = 0; i < send_string_batch.count; i++) {
+    if (send_string_batch.keys[i] == keycode) return false;
+  }
+  return true;
+}
+
+static void send_string_batch_char(char ascii_code) {
+  uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+  bool shifted = pgm_read_byte(&ascii_to_shift_lut[(uint8_t)ascii_code]);
+  if (!keycode) return;
+  if (send_string_batch.count && !send_string_batch_accepts(keycode, shifted)) {
+    send_string_batch_flush();
+  }
+  if (!send_string_batch.count) {
+    send_string_batch.size = SEND_STRING_BATCH_SIZE;
+#ifdef NKRO_ENABLE
+    if (!(keyboard_protocol && keymap_config.nkro))
+#endif
+    {
+      // leave room for any keys that are physically held
+      uint8_t free = KEYBOARD_REPORT_KEYS - has_anykey(keyboard_report);
+      if (free < send_string_batch.size) {
+        send_string_batch.size = free;
+      }
+      if (!send_string_batch.size) {
+        send_char(ascii_code);
+        return;
+      }
+    }
+    send_string_batch.shifted = shifted;
+    if (shifted) {
+      register_code(KC_LSFT);
+    }
+  }
+  add_key(keycode);
+  send_string_batch.keys[send_string_batch.count++] = keycode;
+}
+#else
+  #define send_string_batch_char(ascii_code) send_char(ascii_code)
+  #define send_string_batch_flush()
+#endif
+
+// Streams a string out of any byte addressable storage (RAM, PROGMEM, EEPROM),
+// so callers never need to copy it into a temporary RAM buffer first.
+void send_string_with_reader(const char *str, uint8_t interval, send_string_reader_t read_byte) {
     while (1) {
-        char ascii_code = pgm_read_byte(str);
+        char ascii_code = read_byte(str);
         if (!ascii_code) break;
-        if (ascii_code == 1) {
-          // tap
-          uint8_t keycode = pgm_read_byte(++str);
-          register_code(keycode);
-          unregister_code(keycode);
-        } else if (ascii_code == 2) {
-          // down
-          uint8_t keycode = pgm_read_byte(++str);
-          register_code(keycode);
-        } else if (ascii_code == 3) {
-          // up
-          uint8_t keycode = pgm_read_byte(++str);
-          unregister_code(keycode);
-        } else {
+        if (ascii_code == 1 || ascii_code == 2 || ascii_code == 3) {
+          uint8_t keycode = read_byte(++str);
+          // a truncated tap/down/up sequence, don't read past the terminator
+          if (!keycode) break;
+          send_string_batch_flush();
+          if (ascii_code == 1) {
+            // tap
+            register_code(keycode);
+            unregister_code(keycode);
+          } else if (ascii_code == 2) {
+            // down
+            register_code(keycode);
+          } else {
+            // up
+            unregister_code(keycode);
+          }
+        } else if (interval) {
           send_char(ascii_code);
+        } else {
+          send_string_batch_char(ascii_code);
         }
         ++str;
         // interval
         { uint8_t ms = interval; while (ms--) wait_ms(1); }
     }
+    send_string_batch_flush();
 }
 
 void send_char(char ascii_code) {
@@ -1064,11 +1147,13 @@ void matrix_init_quantum() {
   matrix_init_kb();
 }
 
+#ifndef RGB_MATRIX_FRAMERATE
 uint8_t rgb_matrix_task_counter = 0;
 
 #ifndef RGB_MATRIX_SKIP_FRAMES
   #define RGB_MATRIX_SKIP_FRAMES 1
 #endif
+#endif
 
 void matrix_scan_quantum() {
   #if defined(AUDIO_ENABLE) && !defined(NO_MUSIC_MODE)
@@ -1083,6 +1168,14 @@ void matrix_scan_quantum() {
     matrix_scan_combo();
   #endif
 
+  #if defined(LEADER_ENABLE) && defined(LEADER_SEQUENCE_COUNT)
+    matrix_scan_leader();
+  #endif
+
+  #ifdef AUTO_SHIFT_ENABLE
+    matrix_scan_auto_shift();
+  #endif
+
   #if defined(BACKLIGHT_ENABLE)
     #if defined(LED_MATRIX_ENABLE)
         led_matrix_task();
@@ -1093,10 +1186,12 @@ void matrix_scan_quantum() {
 
   #ifdef RGB_MATRIX_ENABLE
     rgb_matrix_task();
+    #ifndef RGB_MATRIX_FRAMERATE
     if (rgb_matrix_task_counter == 0) {
       rgb_matrix_update_pwm_buffers();
     }
     rgb_matrix_task_counter = ((rgb_matrix_task_counter + 1) % (RGB_MATRIX_SKIP_FRAMES + 1));
+    #endif
   #endif
 
   #ifdef ENCODER_ENABLE
@@ -1107,6 +1202,10 @@ void matrix_scan_quantum() {
     haptic_task();
   #endif
 
+  #ifdef I2C_QUEUE_ENABLE
+    i2c_queue_task();
+  #endif
+
   matrix_scan_kb();
 }
 #if defined(BACKLIGHT_ENABLE) && defined(BACKLIGHT_PIN)
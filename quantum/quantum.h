@@ -211,6 +211,8 @@ void send_string(const char *str);
 void send_string_with_delay(const char *str, uint8_t interval);
 void send_string_P(const char *str);
 void send_string_with_delay_P(const char *str, uint8_t interval);
+typedef uint8_t (*send_string_reader_t)(const char *str);
+void send_string_with_reader(const char *str, uint8_t interval, send_string_reader_t read_byte);
 void send_char(char ascii_code);
 
 // For tri-layer
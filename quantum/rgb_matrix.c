@@ -21,8 +21,8 @@
 #include "progmem.h"
 #include "config.h"
 #include "eeprom.h"
+#include "fixed_math.h"
 #include <string.h>
-#include <math.h>
 
 rgb_config_t rgb_matrix_config;
 
@@ -55,6 +55,10 @@ rgb_config_t rgb_matrix_config;
     #define RGB_DIGITAL_RAIN_DROPS 24
 #endif
 
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+    #define RGB_MATRIX_LED_PROCESS_LIMIT DRIVER_LED_TOTAL
+#endif
+
 #if !defined(DISABLE_RGB_MATRIX_RAINDROPS) || !defined(DISABLE_RGB_MATRIX_JELLYBEAN_RAINDROPS) || !defined(DISABLE_RGB_MATRIX_DIGITAL_RAIN)
     #define TRACK_PREVIOUS_EFFECT
 #endif
@@ -70,9 +74,15 @@ uint8_t g_key_hit[DRIVER_LED_TOTAL];
 // Ticks since any key was last hit.
 uint32_t g_any_key_hit = 0;
 
-#ifndef PI
-#define PI 3.14159265
-#endif
+// The frame being rendered. Effects that can be drawn in slices only touch
+// the LEDs from led_min up to led_max.
+static struct {
+    uint8_t effect;
+    bool initialize;
+    bool suspended;
+    uint8_t led_min;
+    uint8_t led_max;
+} rgb_frame = { .led_max = DRIVER_LED_TOTAL };
 
 uint32_t eeconfig_read_rgb_matrix(void) {
   return eeprom_read_dword(EECONFIG_RGB_MATRIX);
@@ -106,24 +116,75 @@ void eeconfig_debug_rgb_matrix(void) {
 }
 
 // Last led hit
-#define LED_HITS_TO_REMEMBER 8
+#ifndef LED_HITS_TO_REMEMBER
+    #define LED_HITS_TO_REMEMBER 8
+#endif
+// Ring buffer, the newest hit is stored just before g_last_led_head
 uint8_t g_last_led_hit[LED_HITS_TO_REMEMBER] = {255};
+uint8_t g_last_led_head = 0;
 uint8_t g_last_led_count = 0;
 
+// Reverse of g_rgb_leds: the first LED under each key, and for every LED the
+// next one under the same key, so a keypress only visits its own LEDs
+#define NO_LED 255
+static uint8_t g_key_first_led[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t g_key_next_led[DRIVER_LED_TOTAL];
+
+static void build_row_column_to_led_map(void) {
+    memset(g_key_first_led, NO_LED, sizeof(g_key_first_led));
+    // Walk backwards so the LEDs of each key are chained in index order
+    for (uint8_t i = DRIVER_LED_TOTAL; i-- > 0;) {
+        uint8_t row = g_rgb_leds[i].matrix_co.row;
+        uint8_t col = g_rgb_leds[i].matrix_co.col;
+        g_key_next_led[i] = NO_LED;
+        if (row < MATRIX_ROWS && col < MATRIX_COLS) {
+            g_key_next_led[i] = g_key_first_led[row][col];
+            g_key_first_led[row][col] = i;
+        }
+    }
+}
+
 void map_row_column_to_led( uint8_t row, uint8_t column, uint8_t *led_i, uint8_t *led_count) {
-    rgb_led led;
     *led_count = 0;
+    // TICK and events synthesized by user code use positions like 255, 255
+    if (row >= MATRIX_ROWS || column >= MATRIX_COLS) {
+        return;
+    }
 
-    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
-        // map_index_to_led(i, &led);
-        led = g_rgb_leds[i];
-        if (row == led.matrix_co.row && column == led.matrix_co.col) {
-            led_i[*led_count] = i;
-            (*led_count)++;
-        }
+    for (uint8_t i = g_key_first_led[row][column]; i != NO_LED; i = g_key_next_led[i]) {
+        led_i[*led_count] = i;
+        (*led_count)++;
     }
 }
 
+#ifdef RGB_MATRIX_FRAMEBUFFER
+// Effects draw into this buffer, one color per LED in g_rgb_leds order, and
+// the driver takes the whole frame at once when it is flushed.
+RGB g_rgb_frame_buffer[DRIVER_LED_TOTAL];
+
+void rgb_matrix_update_pwm_buffers(void) {
+    if (rgb_matrix_driver.flush_framebuffer) {
+        rgb_matrix_driver.flush_framebuffer(g_rgb_frame_buffer);
+        return;
+    }
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        rgb_matrix_driver.set_color(i, g_rgb_frame_buffer[i].r, g_rgb_frame_buffer[i].g, g_rgb_frame_buffer[i].b);
+    }
+    rgb_matrix_driver.flush();
+}
+
+void rgb_matrix_set_color( int index, uint8_t red, uint8_t green, uint8_t blue ) {
+    if ( index >= 0 && index < DRIVER_LED_TOTAL ) {
+        g_rgb_frame_buffer[index] = (RGB){ .r = red, .g = green, .b = blue };
+    }
+}
+
+void rgb_matrix_set_color_all( uint8_t red, uint8_t green, uint8_t blue ) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        g_rgb_frame_buffer[i] = (RGB){ .r = red, .g = green, .b = blue };
+    }
+}
+#else
 void rgb_matrix_update_pwm_buffers(void) {
     rgb_matrix_driver.flush();
 }
@@ -135,16 +196,34 @@ void rgb_matrix_set_color( int index, uint8_t red, uint8_t green, uint8_t blue )
 void rgb_matrix_set_color_all( uint8_t red, uint8_t green, uint8_t blue ) {
     rgb_matrix_driver.set_color_all(red, green, blue);
 }
+#endif
+
+// Effects that work out a color per LED convert them a chunk at a time, so
+// hsv_to_rgb_buffer() can reuse the gamma corrected brightness from one LED
+// to the next. With a frame buffer the colors go straight into it.
+#define RGB_MATRIX_HSV_CHUNK 16
+
+static void rgb_matrix_set_hsv_chunk(uint16_t first, const HSV *hsv, uint8_t count) {
+#ifdef RGB_MATRIX_FRAMEBUFFER
+    hsv_to_rgb_buffer(hsv, g_rgb_frame_buffer + first, count);
+#else
+    RGB rgb[RGB_MATRIX_HSV_CHUNK];
+    hsv_to_rgb_buffer(hsv, rgb, count);
+    for (uint8_t i = 0; i < count; i++) {
+        rgb_matrix_set_color(first + i, rgb[i].r, rgb[i].g, rgb[i].b);
+    }
+#endif
+}
 
 bool process_rgb_matrix(uint16_t keycode, keyrecord_t *record) {
     if ( record->event.pressed ) {
         uint8_t led[8], led_count;
         map_row_column_to_led(record->event.key.row, record->event.key.col, led, &led_count);
         if (led_count > 0) {
-            for (uint8_t i = LED_HITS_TO_REMEMBER; i > 1; i--) {
-                g_last_led_hit[i - 1] = g_last_led_hit[i - 2];
+            g_last_led_hit[g_last_led_head] = led[0];
+            if (++g_last_led_head == LED_HITS_TO_REMEMBER) {
+                g_last_led_head = 0;
             }
-            g_last_led_hit[0] = led[0];
             g_last_led_count = MIN(LED_HITS_TO_REMEMBER, g_last_led_count + 1);
         }
         for(uint8_t i = 0; i < led_count; i++)
@@ -210,7 +289,7 @@ void rgb_matrix_solid_color(void) {
 
 void rgb_matrix_solid_reactive(void) {
 	// Relies on hue being 8-bit and wrapping
-	for ( int i=0; i<DRIVER_LED_TOTAL; i++ )
+	for ( int i = rgb_frame.led_min; i < rgb_frame.led_max; i++ )
 	{
 		uint16_t offset2 = g_key_hit[i]<<2;
 		offset2 = (offset2<=130) ? (130-offset2) : 0;
@@ -228,7 +307,7 @@ void rgb_matrix_alphas_mods(void) {
     RGB rgb2 = hsv_to_rgb( (HSV){ .h = (rgb_matrix_config.hue + 180) % 360, .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val } );
 
     rgb_led led;
-    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+    for (int i = rgb_frame.led_min; i < rgb_frame.led_max; i++) {
         led = g_rgb_leds[i];
         if ( led.matrix_co.raw < 0xFF ) {
             if ( led.modifier )
@@ -243,6 +322,37 @@ void rgb_matrix_alphas_mods(void) {
     }
 }
 
+#ifdef RGB_MATRIX_EFFECT_CACHE
+// The cycle effects only ever show full saturation hues at the configured
+// brightness, and the gradient only one color per band of rows, so both are
+// converted once when the config changes and then looked up every frame.
+static struct {
+    uint16_t palette_val;
+    uint16_t gradient_hue;
+    uint16_t gradient_sat;
+    uint16_t gradient_val;
+    RGB palette[256];
+    RGB gradient[16];
+} rgb_effect_cache = { .palette_val = 0xFFFF, .gradient_val = 0xFFFF };
+
+static void rgb_matrix_cache_palette(void) {
+    if ( rgb_effect_cache.palette_val == rgb_matrix_config.val ) {
+        return;
+    }
+    HSV hsv = { .h = 0, .s = 255, .v = rgb_matrix_config.val };
+    for ( uint16_t h = 0; h < 256; h++ ) {
+        hsv.h = h;
+        rgb_effect_cache.palette[h] = hsv_to_rgb( hsv );
+    }
+    rgb_effect_cache.palette_val = rgb_matrix_config.val;
+}
+
+#define RAINBOW_RGB(hue) ( rgb_effect_cache.palette[(uint8_t)(hue)] )
+#else
+#define rgb_matrix_cache_palette()
+#define RAINBOW_RGB(hue) hsv_to_rgb( (HSV){ .h = (hue), .s = 255, .v = rgb_matrix_config.val } )
+#endif
+
 void rgb_matrix_gradient_up_down(void) {
     int16_t h1 = rgb_matrix_config.hue;
     int16_t h2 = (rgb_matrix_config.hue + 180) % 360;
@@ -267,16 +377,36 @@ void rgb_matrix_gradient_up_down(void) {
     HSV hsv = { .h = 0, .s = 255, .v = rgb_matrix_config.val };
     RGB rgb;
     Point point;
-    for ( int i=0; i<DRIVER_LED_TOTAL; i++ )
+
+#ifdef RGB_MATRIX_EFFECT_CACHE
+    if ( rgb_effect_cache.gradient_hue != rgb_matrix_config.hue ||
+         rgb_effect_cache.gradient_sat != rgb_matrix_config.sat ||
+         rgb_effect_cache.gradient_val != rgb_matrix_config.val ) {
+        for ( uint8_t y = 0; y < 16; y++ ) {
+            hsv.h = rgb_matrix_config.hue + ( deltaH * y );
+            hsv.s = rgb_matrix_config.sat + ( deltaS * y );
+            rgb_effect_cache.gradient[y] = hsv_to_rgb( hsv );
+        }
+        rgb_effect_cache.gradient_hue = rgb_matrix_config.hue;
+        rgb_effect_cache.gradient_sat = rgb_matrix_config.sat;
+        rgb_effect_cache.gradient_val = rgb_matrix_config.val;
+    }
+#endif
+
+    for ( int i = rgb_frame.led_min; i < rgb_frame.led_max; i++ )
     {
         // map_led_to_point( i, &point );
         point = g_rgb_leds[i].point;
         // The y range will be 0..64, map this to 0..4
         uint8_t y = (point.y>>4);
+#ifdef RGB_MATRIX_EFFECT_CACHE
+        rgb = rgb_effect_cache.gradient[y];
+#else
         // Relies on hue being 8-bit and wrapping
         hsv.h = rgb_matrix_config.hue + ( deltaH * y );
         hsv.s = rgb_matrix_config.sat + ( deltaS * y );
         rgb = hsv_to_rgb( hsv );
+#endif
         rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
     }
 }
@@ -329,8 +459,10 @@ void rgb_matrix_cycle_all(void) {
 
     rgb_led led;
 
+    rgb_matrix_cache_palette();
+
     // Relies on hue being 8-bit and wrapping
-    for ( int i=0; i<DRIVER_LED_TOTAL; i++ )
+    for ( int i = rgb_frame.led_min; i < rgb_frame.led_max; i++ )
     {
         // map_index_to_led(i, &led);
         led = g_rgb_leds[i];
@@ -338,8 +470,7 @@ void rgb_matrix_cycle_all(void) {
             uint16_t offset2 = g_key_hit[i]<<2;
             offset2 = (offset2<=63) ? (63-offset2) : 0;
 
-            HSV hsv = { .h = offset+offset2, .s = 255, .v = rgb_matrix_config.val };
-            RGB rgb = hsv_to_rgb( hsv );
+            RGB rgb = RAINBOW_RGB( offset + offset2 );
             rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
         }
     }
@@ -347,11 +478,13 @@ void rgb_matrix_cycle_all(void) {
 
 void rgb_matrix_cycle_left_right(void) {
     uint8_t offset = ( g_tick << rgb_matrix_config.speed ) & 0xFF;
-    HSV hsv = { .h = 0, .s = 255, .v = rgb_matrix_config.val };
     RGB rgb;
     Point point;
     rgb_led led;
-    for ( int i=0; i<DRIVER_LED_TOTAL; i++ )
+
+    rgb_matrix_cache_palette();
+
+    for ( int i = rgb_frame.led_min; i < rgb_frame.led_max; i++ )
     {
         // map_index_to_led(i, &led);
         led = g_rgb_leds[i];
@@ -362,8 +495,7 @@ void rgb_matrix_cycle_left_right(void) {
             // map_led_to_point( i, &point );
             point = g_rgb_leds[i].point;
             // Relies on hue being 8-bit and wrapping
-            hsv.h = point.x + offset + offset2;
-            rgb = hsv_to_rgb( hsv );
+            rgb = RAINBOW_RGB( point.x + offset + offset2 );
             rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
         }
     }
@@ -371,11 +503,13 @@ void rgb_matrix_cycle_left_right(void) {
 
 void rgb_matrix_cycle_up_down(void) {
     uint8_t offset = ( g_tick << rgb_matrix_config.speed ) & 0xFF;
-    HSV hsv = { .h = 0, .s = 255, .v = rgb_matrix_config.val };
     RGB rgb;
     Point point;
     rgb_led led;
-    for ( int i=0; i<DRIVER_LED_TOTAL; i++ )
+
+    rgb_matrix_cache_palette();
+
+    for ( int i = rgb_frame.led_min; i < rgb_frame.led_max; i++ )
     {
         // map_index_to_led(i, &led);
         led = g_rgb_leds[i];
@@ -386,8 +520,7 @@ void rgb_matrix_cycle_up_down(void) {
             // map_led_to_point( i, &point );
             point = g_rgb_leds[i].point;
             // Relies on hue being 8-bit and wrapping
-            hsv.h = point.y + offset + offset2;
-            rgb = hsv_to_rgb( hsv );
+            rgb = RAINBOW_RGB( point.y + offset + offset2 );
             rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
         }
     }
@@ -395,60 +528,76 @@ void rgb_matrix_cycle_up_down(void) {
 
 
 void rgb_matrix_dual_beacon(void) {
-    HSV hsv = { .h = rgb_matrix_config.hue, .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val };
-    RGB rgb;
-    Point point;
-    double cos_value = cos(g_tick * PI / 128) / 32;
-    double sin_value =  sin(g_tick * PI / 128) / 112;
-    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
-        point = g_rgb_leds[i].point;
-        hsv.h = ((point.y - 32.0)* cos_value + (point.x - 112.0) * sin_value) * (180) + rgb_matrix_config.hue;
-        rgb = hsv_to_rgb( hsv );
-        rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
+    HSV hsv[RGB_MATRIX_HSV_CHUNK];
+    int32_t cos_value = (int32_t)cos16(g_tick) * 180 / 32;
+    int32_t sin_value = (int32_t)sin16(g_tick) * 180 / 112;
+    for (uint16_t first = rgb_frame.led_min; first < rgb_frame.led_max; first += RGB_MATRIX_HSV_CHUNK) {
+        uint8_t count = MIN(RGB_MATRIX_HSV_CHUNK, rgb_frame.led_max - first);
+        for (uint8_t n = 0; n < count; n++) {
+            Point point = g_rgb_leds[first + n].point;
+            hsv[n].h = (((point.y - 32) * cos_value + (point.x - 112) * sin_value) >> 15) + rgb_matrix_config.hue;
+            hsv[n].s = rgb_matrix_config.sat;
+            hsv[n].v = rgb_matrix_config.val;
+        }
+        rgb_matrix_set_hsv_chunk(first, hsv, count);
     }
 }
 
 void rgb_matrix_rainbow_beacon(void) {
-    HSV hsv = { .h = rgb_matrix_config.hue, .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val };
-    RGB rgb;
-    Point point;
-    double cos_value = cos(g_tick * PI / 128);
-    double sin_value =  sin(g_tick * PI / 128);
-    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
-        point = g_rgb_leds[i].point;
-        hsv.h = (1.5 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed)) * (point.y - 32.0)* cos_value + (1.5 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed)) * (point.x - 112.0) * sin_value + rgb_matrix_config.hue;
-        rgb = hsv_to_rgb( hsv );
-        rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
+    HSV hsv[RGB_MATRIX_HSV_CHUNK];
+    // 1.5 * speed, the extra halving is folded into the final shift
+    int16_t scale = 3 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed);
+    int32_t cos_value = cos16(g_tick);
+    int32_t sin_value = sin16(g_tick);
+    for (uint16_t first = rgb_frame.led_min; first < rgb_frame.led_max; first += RGB_MATRIX_HSV_CHUNK) {
+        uint8_t count = MIN(RGB_MATRIX_HSV_CHUNK, rgb_frame.led_max - first);
+        for (uint8_t n = 0; n < count; n++) {
+            Point point = g_rgb_leds[first + n].point;
+            // sum * scale passes 32 bits above speed 187, so the high and low
+            // bytes of the sum are scaled apart, which rounds the same way
+            int32_t sum = (point.y - 32) * cos_value + (point.x - 112) * sin_value;
+            int32_t scaled = (sum >> 8) * scale + (((sum & 0xFF) * scale) >> 8);
+            hsv[n].h = (scaled >> 8) + rgb_matrix_config.hue;
+            hsv[n].s = rgb_matrix_config.sat;
+            hsv[n].v = rgb_matrix_config.val;
+        }
+        rgb_matrix_set_hsv_chunk(first, hsv, count);
     }
 }
 
 void rgb_matrix_rainbow_pinwheels(void) {
-    HSV hsv = { .h = rgb_matrix_config.hue, .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val };
-    RGB rgb;
-    Point point;
-    double cos_value = cos(g_tick * PI / 128);
-    double sin_value =  sin(g_tick * PI / 128);
-    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
-        point = g_rgb_leds[i].point;
-        hsv.h = (2 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed)) * (point.y - 32.0)* cos_value + (2 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed)) * (66 - abs(point.x - 112.0)) * sin_value + rgb_matrix_config.hue;
-        rgb = hsv_to_rgb( hsv );
-        rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
+    HSV hsv[RGB_MATRIX_HSV_CHUNK];
+    int16_t scale = 2 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed);
+    int32_t cos_value = (int32_t)cos16(g_tick) * scale;
+    int32_t sin_value = (int32_t)sin16(g_tick) * scale;
+    for (uint16_t first = rgb_frame.led_min; first < rgb_frame.led_max; first += RGB_MATRIX_HSV_CHUNK) {
+        uint8_t count = MIN(RGB_MATRIX_HSV_CHUNK, rgb_frame.led_max - first);
+        for (uint8_t n = 0; n < count; n++) {
+            Point point = g_rgb_leds[first + n].point;
+            hsv[n].h = (((point.y - 32) * cos_value + (66 - abs(point.x - 112)) * sin_value) >> 15) + rgb_matrix_config.hue;
+            hsv[n].s = rgb_matrix_config.sat;
+            hsv[n].v = rgb_matrix_config.val;
+        }
+        rgb_matrix_set_hsv_chunk(first, hsv, count);
     }
 }
 
 void rgb_matrix_rainbow_moving_chevron(void) {
-    HSV hsv = { .h = rgb_matrix_config.hue, .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val };
-    RGB rgb;
-    Point point;
-    uint8_t r = 128;
-    double cos_value = cos(r * PI / 128);
-    double sin_value =  sin(r * PI / 128);
-    double multiplier = (g_tick / 256.0 * 224);
-    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
-        point = g_rgb_leds[i].point;
-        hsv.h = (1.5 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed)) * abs(point.y - 32.0)* sin_value + (1.5 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed)) * (point.x - multiplier) * cos_value + rgb_matrix_config.hue;
-        rgb = hsv_to_rgb( hsv );
-        rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
+    HSV hsv[RGB_MATRIX_HSV_CHUNK];
+    // The chevron is drawn at a fixed angle of 180 degrees, so only the x term
+    // remains: 1.5 * speed * (g_tick * 7 / 8 - x). The hue repeats every 4096
+    // ticks, which keeps the products within 32 bits.
+    int16_t scale = 3 * (rgb_matrix_config.speed == 0 ? 1 : rgb_matrix_config.speed);
+    int32_t multiplier = 7 * (int32_t)(g_tick & 0xFFF);
+    for (uint16_t first = rgb_frame.led_min; first < rgb_frame.led_max; first += RGB_MATRIX_HSV_CHUNK) {
+        uint8_t count = MIN(RGB_MATRIX_HSV_CHUNK, rgb_frame.led_max - first);
+        for (uint8_t n = 0; n < count; n++) {
+            Point point = g_rgb_leds[first + n].point;
+            hsv[n].h = ((scale * (multiplier - 8 * point.x)) >> 4) + rgb_matrix_config.hue;
+            hsv[n].s = rgb_matrix_config.sat;
+            hsv[n].v = rgb_matrix_config.val;
+        }
+        rgb_matrix_set_hsv_chunk(first, hsv, count);
     }
 }
 
@@ -539,34 +688,65 @@ void rgb_matrix_digital_rain( const bool initialize ) {
     }
 }
 
+typedef struct {
+    Point point;
+    uint16_t radius;
+    uint32_t inner_sq;
+    uint32_t outer_sq;
+} splash_hit;
+
+// The remembered hits, newest first, together with the squared bounds of
+// their rings so most LEDs can be classified without a square root. Kept out
+// of the effects' stack, which has no room for them on AVR.
+static splash_hit g_splash_hits[LED_HITS_TO_REMEMBER];
+
+static uint8_t rgb_matrix_splash_hits(void) {
+    uint8_t index = g_last_led_head;
+    for (uint8_t i = 0; i < g_last_led_count; i++) {
+        index = (index == 0 ? LED_HITS_TO_REMEMBER : index) - 1;
+        uint8_t led = g_last_led_hit[index];
+        uint16_t radius = g_key_hit[led] << 2;
+        uint16_t inner = radius > 254 ? radius - 254 : 0;
+        g_splash_hits[i].point = g_rgb_leds[led].point;
+        g_splash_hits[i].radius = radius;
+        g_splash_hits[i].inner_sq = (uint32_t)inner * inner;
+        g_splash_hits[i].outer_sq = (uint32_t)(radius + 1) * (radius + 1);
+    }
+    return g_last_led_count;
+}
+
+// Returns how far the ring of a hit has travelled past the LED, 0 on the wave
+// front and 255 once it has passed. LEDs the ring has not reached yet are
+// also 255.
+static uint8_t rgb_matrix_splash_effect(Point point, const splash_hit *hit) {
+    uint8_t dx = point.x > hit->point.x ? point.x - hit->point.x : hit->point.x - point.x;
+    uint8_t dy = point.y > hit->point.y ? point.y - hit->point.y : hit->point.y - point.y;
+    uint32_t dist_sq = (uint32_t)dx * dx + (uint32_t)dy * dy;
+    if (dist_sq < hit->inner_sq || dist_sq >= hit->outer_sq) {
+        return 255;
+    }
+    return MIN((uint16_t)(hit->radius - sqrt32(dist_sq)), 255);
+}
+
 void rgb_matrix_multisplash(void) {
-    // if (g_any_key_hit < 0xFF) {
-        HSV hsv = { .h = rgb_matrix_config.hue, .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val };
-        RGB rgb;
-        rgb_led led;
-        for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
-            led = g_rgb_leds[i];
+    HSV hsv[RGB_MATRIX_HSV_CHUNK];
+    uint8_t hit_count = rgb_matrix_splash_hits();
+    for (uint16_t first = rgb_frame.led_min; first < rgb_frame.led_max; first += RGB_MATRIX_HSV_CHUNK) {
+        uint8_t count = MIN(RGB_MATRIX_HSV_CHUNK, rgb_frame.led_max - first);
+        for (uint8_t n = 0; n < count; n++) {
+            Point point = g_rgb_leds[first + n].point;
             uint16_t c = 0, d = 0;
-            rgb_led last_led;
-            // if (g_last_led_count) {
-                for (uint8_t last_i = 0; last_i < g_last_led_count; last_i++) {
-                    last_led = g_rgb_leds[g_last_led_hit[last_i]];
-                    uint16_t dist = (uint16_t)sqrt(pow(led.point.x - last_led.point.x, 2) + pow(led.point.y - last_led.point.y, 2));
-                    uint16_t effect = (g_key_hit[g_last_led_hit[last_i]] << 2) - dist;
-                    c += MIN(MAX(effect, 0), 255);
-                    d += 255 - MIN(MAX(effect, 0), 255);
-                }
-            // } else {
-            //     d = 255;
-            // }
-            hsv.h = (rgb_matrix_config.hue + c) % 256;
-            hsv.v = MAX(MIN(d, 255), 0);
-            rgb = hsv_to_rgb( hsv );
-            rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
+            for (uint8_t last_i = 0; last_i < hit_count; last_i++) {
+                uint8_t effect = rgb_matrix_splash_effect(point, &g_splash_hits[last_i]);
+                c += effect;
+                d += 255 - effect;
+            }
+            hsv[n].h = (rgb_matrix_config.hue + c) % 256;
+            hsv[n].s = rgb_matrix_config.sat;
+            hsv[n].v = MIN(d, 255);
         }
-    // } else {
-        // rgb_matrix_set_color_all( 0, 0, 0 );
-    // }
+        rgb_matrix_set_hsv_chunk(first, hsv, count);
+    }
 }
 
 
@@ -577,31 +757,22 @@ void rgb_matrix_splash(void) {
 
 
 void rgb_matrix_solid_multisplash(void) {
-    // if (g_any_key_hit < 0xFF) {
-        HSV hsv = { .h = rgb_matrix_config.hue, .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val };
-        RGB rgb;
-        rgb_led led;
-        for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
-            led = g_rgb_leds[i];
+    HSV hsv[RGB_MATRIX_HSV_CHUNK];
+    uint8_t hit_count = rgb_matrix_splash_hits();
+    for (uint16_t first = rgb_frame.led_min; first < rgb_frame.led_max; first += RGB_MATRIX_HSV_CHUNK) {
+        uint8_t count = MIN(RGB_MATRIX_HSV_CHUNK, rgb_frame.led_max - first);
+        for (uint8_t n = 0; n < count; n++) {
+            Point point = g_rgb_leds[first + n].point;
             uint16_t d = 0;
-            rgb_led last_led;
-            // if (g_last_led_count) {
-                for (uint8_t last_i = 0; last_i < g_last_led_count; last_i++) {
-                    last_led = g_rgb_leds[g_last_led_hit[last_i]];
-                    uint16_t dist = (uint16_t)sqrt(pow(led.point.x - last_led.point.x, 2) + pow(led.point.y - last_led.point.y, 2));
-                    uint16_t effect = (g_key_hit[g_last_led_hit[last_i]] << 2) - dist;
-                    d += 255 - MIN(MAX(effect, 0), 255);
-                }
-            // } else {
-            //     d = 255;
-            // }
-            hsv.v = MAX(MIN(d, 255), 0);
-            rgb = hsv_to_rgb( hsv );
-            rgb_matrix_set_color( i, rgb.r, rgb.g, rgb.b );
+            for (uint8_t last_i = 0; last_i < hit_count; last_i++) {
+                d += 255 - rgb_matrix_splash_effect(point, &g_splash_hits[last_i]);
+            }
+            hsv[n].h = rgb_matrix_config.hue;
+            hsv[n].s = rgb_matrix_config.sat;
+            hsv[n].v = MIN(d, 255);
         }
-    // } else {
-        // rgb_matrix_set_color_all( 0, 0, 0 );
-    // }
+        rgb_matrix_set_hsv_chunk(first, hsv, count);
+    }
 }
 
 
@@ -626,7 +797,9 @@ void rgb_matrix_custom(void) {
 //     }
 }
 
-void rgb_matrix_task(void) {
+// Sets up the next frame: advances the tick and picks the effect. Returns
+// false if the frame was already handled, for instance while disabled.
+static bool rgb_matrix_frame_begin(void) {
   #ifdef TRACK_PREVIOUS_EFFECT
       static uint8_t toggle_enable_last = 255;
   #endif
@@ -636,13 +809,13 @@ void rgb_matrix_task(void) {
      #ifdef TRACK_PREVIOUS_EFFECT
          toggle_enable_last = rgb_matrix_config.enable;
      #endif
-     return;
+     return false;
     }
     // delay 1 second before driving LEDs or doing anything else
     static uint8_t startup_tick = 0;
     if ( startup_tick < 20 ) {
         startup_tick++;
-        return;
+        return false;
     }
 
     g_tick++;
@@ -662,14 +835,14 @@ void rgb_matrix_task(void) {
     // Factory default magic value
     if ( rgb_matrix_config.mode == 255 ) {
         rgb_matrix_test();
-        return;
+        return false;
     }
 
     // Ideally we would also stop sending zeros to the LED driver PWM buffers
     // while suspended and just do a software shutdown. This is a cheap hack for now.
-    bool suspend_backlight = ((g_suspend_state && RGB_DISABLE_WHEN_USB_SUSPENDED) ||
+    rgb_frame.suspended = ((g_suspend_state && RGB_DISABLE_WHEN_USB_SUSPENDED) ||
             (RGB_DISABLE_AFTER_TIMEOUT > 0 && g_any_key_hit > RGB_DISABLE_AFTER_TIMEOUT * 60 * 20));
-    uint8_t effect = suspend_backlight ? 0 : rgb_matrix_config.mode;
+    rgb_frame.effect = rgb_frame.suspended ? 0 : rgb_matrix_config.mode;
 
     #ifdef TRACK_PREVIOUS_EFFECT
         // Keep track of the effect used last time,
@@ -677,18 +850,25 @@ void rgb_matrix_task(void) {
         // have an optional initialization.
 
         static uint8_t effect_last = 255;
-        bool initialize = (effect != effect_last) || (rgb_matrix_config.enable != toggle_enable_last);
-        effect_last = effect;
+        rgb_frame.initialize = (rgb_frame.effect != effect_last) || (rgb_matrix_config.enable != toggle_enable_last);
+        effect_last = rgb_frame.effect;
         toggle_enable_last = rgb_matrix_config.enable;
     #endif
 
+    return true;
+}
+
+// Renders the LEDs from rgb_frame.led_min up to rgb_frame.led_max. Returns
+// true if the effect drew the whole frame at once, which effects that keep
+// state across LEDs have to.
+static bool rgb_matrix_render(void) {
     // this gets ticked at 20 Hz.
     // each effect can opt to do calculations
     // and/or request PWM buffer updates.
-    switch ( effect ) {
+    switch ( rgb_frame.effect ) {
         case RGB_MATRIX_SOLID_COLOR:
             rgb_matrix_solid_color();
-            break;
+            return true;
         #ifndef DISABLE_RGB_MATRIX_ALPHAS_MODS
             case RGB_MATRIX_ALPHAS_MODS:
                 rgb_matrix_alphas_mods();
@@ -706,8 +886,8 @@ void rgb_matrix_task(void) {
         #endif
         #ifndef DISABLE_RGB_MATRIX_RAINDROPS
             case RGB_MATRIX_RAINDROPS:
-                rgb_matrix_raindrops( initialize );
-                break;
+                rgb_matrix_raindrops( rgb_frame.initialize );
+                return true;
         #endif
         #ifndef DISABLE_RGB_MATRIX_CYCLE_ALL
             case RGB_MATRIX_CYCLE_ALL:
@@ -741,13 +921,13 @@ void rgb_matrix_task(void) {
         #endif
         #ifndef DISABLE_RGB_MATRIX_JELLYBEAN_RAINDROPS
             case RGB_MATRIX_JELLYBEAN_RAINDROPS:
-                rgb_matrix_jellybean_raindrops( initialize );
-                break;
+                rgb_matrix_jellybean_raindrops( rgb_frame.initialize );
+                return true;
         #endif
         #ifndef DISABLE_RGB_MATRIX_DIGITAL_RAIN
             case RGB_MATRIX_DIGITAL_RAIN:
-                rgb_matrix_digital_rain( initialize );
-                break;
+                rgb_matrix_digital_rain( rgb_frame.initialize );
+                return true;
         #endif
         #ifdef RGB_MATRIX_KEYPRESSES
             #ifndef DISABLE_RGB_MATRIX_SOLID_REACTIVE
@@ -778,15 +958,108 @@ void rgb_matrix_task(void) {
         #endif
         default:
             rgb_matrix_custom();
-            break;
+            return true;
     }
 
-    if ( ! suspend_backlight ) {
+    return false;
+}
+
+static void rgb_matrix_frame_end(void) {
+    if ( ! rgb_frame.suspended ) {
         rgb_matrix_indicators();
     }
+}
 
+#ifdef RGB_MATRIX_FRAMERATE
+static enum {
+    RGB_TASK_STARTING,
+    RGB_TASK_RENDERING,
+    RGB_TASK_FLUSHING,
+    RGB_TASK_SYNCING
+} rgb_task_state = RGB_TASK_STARTING;
+
+static uint16_t rgb_frame_start;
+static rgb_matrix_stats_t rgb_stats;
+
+static void rgb_task_start_flush(void) {
+#ifdef RGB_MATRIX_FRAMEBUFFER
+    // flush_block streams what the driver has buffered, so hand it the frame
+    if ( rgb_matrix_driver.flush_block ) {
+        for ( int i = 0; i < DRIVER_LED_TOTAL; i++ ) {
+            rgb_matrix_driver.set_color(i, g_rgb_frame_buffer[i].r, g_rgb_frame_buffer[i].g, g_rgb_frame_buffer[i].b);
+        }
+    }
+#endif
+    rgb_task_state = RGB_TASK_FLUSHING;
 }
 
+// Each call does one step of the frame, either rendering up to
+// RGB_MATRIX_LED_PROCESS_LIMIT LEDs or flushing the driver, one block at a
+// time if it has flush_block, so a long frame is spread over several scans
+// instead of stalling one of them.
+void rgb_matrix_task(void) {
+    uint16_t call_start = timer_read();
+
+    switch ( rgb_task_state ) {
+        case RGB_TASK_SYNCING:
+            if ( timer_elapsed(rgb_frame_start) < 1000 / RGB_MATRIX_FRAMERATE ) {
+                return;
+            }
+            // fall through
+        case RGB_TASK_STARTING:
+            rgb_frame_start = timer_read();
+            if ( !rgb_matrix_frame_begin() ) {
+                rgb_task_start_flush();
+                break;
+            }
+            rgb_frame.led_min = 0;
+            rgb_task_state = RGB_TASK_RENDERING;
+            // fall through
+        case RGB_TASK_RENDERING:
+            rgb_frame.led_max = MIN(rgb_frame.led_min + RGB_MATRIX_LED_PROCESS_LIMIT, DRIVER_LED_TOTAL);
+            if ( rgb_matrix_render() || rgb_frame.led_max == DRIVER_LED_TOTAL ) {
+                rgb_frame.led_min = 0;
+                rgb_frame.led_max = DRIVER_LED_TOTAL;
+                rgb_matrix_frame_end();
+                rgb_task_start_flush();
+            } else {
+                rgb_frame.led_min = rgb_frame.led_max;
+            }
+            break;
+        case RGB_TASK_FLUSHING:
+            if ( rgb_matrix_driver.flush_block ) {
+                if ( rgb_matrix_driver.flush_block() ) {
+                    break;
+                }
+            } else {
+                rgb_matrix_update_pwm_buffers();
+            }
+            rgb_stats.frames++;
+            rgb_stats.frame_time = timer_elapsed(rgb_frame_start);
+            rgb_stats.max_frame_time = MAX(rgb_stats.max_frame_time, rgb_stats.frame_time);
+            rgb_task_state = RGB_TASK_SYNCING;
+            break;
+    }
+
+    rgb_stats.max_stall = MAX(rgb_stats.max_stall, timer_elapsed(call_start));
+}
+
+void rgb_matrix_get_stats(rgb_matrix_stats_t *stats) {
+    *stats = rgb_stats;
+}
+
+void rgb_matrix_reset_stats(void) {
+    memset(&rgb_stats, 0, sizeof(rgb_stats));
+}
+#else
+void rgb_matrix_task(void) {
+    if ( rgb_matrix_frame_begin() ) {
+        rgb_matrix_render();
+        rgb_matrix_frame_end();
+    }
+}
+#endif
+
 void rgb_matrix_indicators(void) {
     rgb_matrix_indicators_kb();
     rgb_matrix_indicators_user();
@@ -819,6 +1092,8 @@ void rgb_matrix_indicators_user(void) {}
 void rgb_matrix_init(void) {
   rgb_matrix_driver.init();
 
+  build_row_column_to_led_map();
+
   // TODO: put the 1 second startup delay here?
 
   // clear the key hits
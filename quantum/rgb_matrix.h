@@ -129,6 +129,11 @@ enum rgb_matrix_effects {
 void rgb_matrix_set_color( int index, uint8_t red, uint8_t green, uint8_t blue );
 void rgb_matrix_set_color_all( uint8_t red, uint8_t green, uint8_t blue );
 
+#ifdef RGB_MATRIX_FRAMEBUFFER
+// The frame being drawn, one color per LED. Effects may write it directly.
+extern RGB g_rgb_frame_buffer[DRIVER_LED_TOTAL];
+#endif
+
 // This runs after another backlight effect and replaces
 // colors already set
 void rgb_matrix_indicators(void);
@@ -144,6 +149,18 @@ void rgb_matrix_set_indicator_state(uint8_t state);
 
 void rgb_matrix_task(void);
 
+#ifdef RGB_MATRIX_FRAMERATE
+typedef struct {
+    uint32_t frames;          // frames flushed to the driver
+    uint16_t frame_time;      // ms from the start of the last frame to its flush
+    uint16_t max_frame_time;
+    uint16_t max_stall;       // longest single rgb_matrix_task() call, in ms
+} rgb_matrix_stats_t;
+
+void rgb_matrix_get_stats(rgb_matrix_stats_t *stats);
+void rgb_matrix_reset_stats(void);
+#endif
+
 // This should not be called from an interrupt
 // (eg. from a timer interrupt).
 // Call this while idle (in between matrix scans).
@@ -216,6 +233,13 @@ typedef struct {
     void (*set_color_all)(uint8_t r, uint8_t g, uint8_t b);
     /* Flush any buffered changes to the hardware. */
     void (*flush)(void);
+    /* Optional: take one color per LED from the frame buffer and flush them
+     * to the hardware. Only used with RGB_MATRIX_FRAMEBUFFER. */
+    void (*flush_framebuffer)(const RGB *leds);
+    /* Optional: send at most one block of the buffered changes to the
+     * hardware, returns true while more are left. Lets RGB_MATRIX_FRAMERATE
+     * spread a flush over several scans. */
+    bool (*flush_block)(void);
 } rgb_matrix_driver_t;
 
 extern const rgb_matrix_driver_t rgb_matrix_driver;
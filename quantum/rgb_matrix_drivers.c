@@ -18,7 +18,8 @@
 
 /* Each driver needs to define the struct
  *    const rgb_matrix_driver_t rgb_matrix_driver;
- * All members must be provided.
+ * All members must be provided, except flush_framebuffer and flush_block
+ * which are optional.
  * Keyboard custom drivers can define this in their own files, it should only
  * be here if shared between boards.
  */
@@ -59,11 +60,24 @@ static void flush( void )
     IS31FL3731_update_pwm_buffers( DRIVER_ADDR_1, DRIVER_ADDR_2 );
 }
 
+static void flush_framebuffer( const RGB *leds )
+{
+    IS31FL3731_set_color_buffer( leds );
+    flush();
+}
+
+static bool flush_block( void )
+{
+    return IS31FL3731_update_pwm_block( DRIVER_ADDR_1, DRIVER_ADDR_2 );
+}
+
 const rgb_matrix_driver_t rgb_matrix_driver = {
     .init = init,
     .flush = flush,
     .set_color = IS31FL3731_set_color,
     .set_color_all = IS31FL3731_set_color_all,
+    .flush_framebuffer = flush_framebuffer,
+    .flush_block = flush_block,
 };
 #else
 static void flush( void )
@@ -71,11 +85,24 @@ static void flush( void )
     IS31FL3733_update_pwm_buffers( DRIVER_ADDR_1, DRIVER_ADDR_2 );
 }
 
+static void flush_framebuffer( const RGB *leds )
+{
+    IS31FL3733_set_color_buffer( leds );
+    flush();
+}
+
+static bool flush_block( void )
+{
+    return IS31FL3733_update_pwm_block( DRIVER_ADDR_1, DRIVER_ADDR_2 );
+}
+
 const rgb_matrix_driver_t rgb_matrix_driver = {
     .init = init,
     .flush = flush,
     .set_color = IS31FL3733_set_color,
     .set_color_all = IS31FL3733_set_color_all,
+    .flush_framebuffer = flush_framebuffer,
+    .flush_block = flush_block,
 };
 #endif
 
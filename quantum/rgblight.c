@@ -45,6 +45,26 @@ static inline int is_static_effect(uint8_t mode) {
     return memchr(static_effect_table, mode, sizeof(static_effect_table)) != NULL;
 }
 
+#define _RGBM_SINGLE_STATIC(sym)   RGBLIGHT_MODE_ ## sym,
+#define _RGBM_SINGLE_DYNAMIC(sym)  RGBLIGHT_MODE_ ## sym,
+#define _RGBM_MULTI_STATIC(sym)    RGBLIGHT_MODE_ ## sym,
+#define _RGBM_MULTI_DYNAMIC(sym)   RGBLIGHT_MODE_ ## sym,
+#define _RGBM_TMP_STATIC(sym)
+#define _RGBM_TMP_DYNAMIC(sym)
+static uint8_t effect_base_table [] = {
+#include "rgblight.h"
+};
+
+// The first mode of the effect a mode belongs to, the other modes of an
+// effect only change its speed or direction
+static uint8_t effect_base(uint8_t mode) {
+    uint8_t base = mode;
+    for (uint8_t i = 0; i < sizeof(effect_base_table) && effect_base_table[i] <= mode; i++) {
+        base = effect_base_table[i];
+    }
+    return base;
+}
+
 #define MIN(a,b) (((a)<(b))?(a):(b))
 #define MAX(a,b) (((a)>(b))?(a):(b))
 
@@ -59,6 +79,23 @@ bool is_rgblight_initialized = false;
 LED_TYPE led[RGBLED_NUM];
 bool rgblight_timer_enabled = false;
 
+// State of the running animation. The effects share it, so a split slave
+// can be put in step with its master by copying it over.
+static struct {
+  uint16_t last_timer;
+  int16_t  pos;
+  int8_t   increment;
+} animation;
+static bool animation_restarted = true;
+static uint32_t synced_config;
+
+static void rgblight_animation_restart(void) {
+  animation.last_timer = timer_read();
+  animation.pos = 0;
+  animation.increment = 1;
+  animation_restarted = true;
+}
+
 void sethsv(uint16_t hue, uint8_t sat, uint8_t val, LED_TYPE *led1) {
   uint8_t r = 0, g = 0, b = 0, base, color;
 
@@ -291,6 +328,7 @@ void rgblight_mode_eeprom_helper(uint8_t mode, bool write_to_eeprom) {
   if (!rgblight_config.enable) {
     return;
   }
+  uint8_t old_mode = rgblight_config.mode;
   if (mode < RGBLIGHT_MODE_STATIC_LIGHT) {
     rgblight_config.mode = RGBLIGHT_MODE_STATIC_LIGHT;
   } else if (mode > RGBLIGHT_MODES) {
@@ -304,6 +342,10 @@ void rgblight_mode_eeprom_helper(uint8_t mode, bool write_to_eeprom) {
   } else {
     xprintf("rgblight mode [NOEEPROM]: %u\n", rgblight_config.mode);
   }
+  // Stepping the speed or direction of the running effect keeps its phase
+  if (effect_base(rgblight_config.mode) != effect_base(old_mode)) {
+    rgblight_animation_restart();
+  }
   if( is_static_effect(rgblight_config.mode) ) {
 #ifdef RGBLIGHT_USE_TIMER
       rgblight_timer_disable();
@@ -644,28 +686,92 @@ void rgblight_sethsv_slave(uint16_t hue, uint8_t sat, uint8_t val) {
 }
 
 #ifndef RGBLIGHT_CUSTOM_DRIVER
+// What the strip was last sent. LEDs past the end of a shorter frame keep
+// their colors, so only the part up to the last changed LED goes out again.
+static LED_TYPE led_sent[RGBLED_NUM];
+static bool led_sent_valid = false;
+static rgblight_stats_t rgblight_stats;
+
 void rgblight_set(void) {
-  if (rgblight_config.enable) {
-    #ifdef RGBW
-      ws2812_setleds_rgbw(led, RGBLED_NUM);
-    #else
-      ws2812_setleds(led, RGBLED_NUM);
-    #endif
-  } else {
+  if (!rgblight_config.enable) {
     for (uint8_t i = 0; i < RGBLED_NUM; i++) {
       led[i].r = 0;
       led[i].g = 0;
       led[i].b = 0;
     }
-    #ifdef RGBW
-      ws2812_setleds_rgbw(led, RGBLED_NUM);
-    #else
-      ws2812_setleds(led, RGBLED_NUM);
-    #endif
   }
+
+  uint16_t length = RGBLED_NUM;
+  if (led_sent_valid) {
+    while (length > 0 && memcmp(&led[length - 1], &led_sent[length - 1], sizeof(LED_TYPE)) == 0) {
+      length--;
+    }
+    if (length == 0) {
+      rgblight_stats.frames_skipped++;
+      return;
+    }
+  }
+
+  #ifdef RGBW
+    ws2812_setleds_rgbw(led, length);
+  #else
+    ws2812_setleds(led, length);
+  #endif
+  memcpy(led_sent, led, length * sizeof(LED_TYPE));
+  led_sent_valid = true;
+
+  rgblight_stats.frames_sent++;
+  rgblight_stats.leds_sent += length;
+}
+
+void rgblight_set_full(void) {
+  led_sent_valid = false;
+  rgblight_set();
+}
+
+void rgblight_get_stats(rgblight_stats_t *stats) {
+  *stats = rgblight_stats;
+}
+
+void rgblight_reset_stats(void) {
+  memset(&rgblight_stats, 0, sizeof(rgblight_stats));
 }
 #endif
 
+bool rgblight_sync_pending(void) {
+  return animation_restarted || rgblight_config.raw != synced_config;
+}
+
+void rgblight_get_syncinfo(rgblight_syncinfo_t *syncinfo) {
+  syncinfo->config = rgblight_config.raw;
+  syncinfo->elapsed = timer_elapsed(animation.last_timer);
+  syncinfo->pos = animation.pos;
+  syncinfo->increment = animation.increment;
+
+  synced_config = rgblight_config.raw;
+  animation_restarted = false;
+}
+
+void rgblight_update_sync(const rgblight_syncinfo_t *syncinfo) {
+  if (syncinfo->config != rgblight_config.raw) {
+    rgblight_config.raw = syncinfo->config;
+    if (rgblight_config.enable) {
+      rgblight_mode_noeeprom(rgblight_config.mode);
+    } else {
+#ifdef RGBLIGHT_USE_TIMER
+      rgblight_timer_disable();
+#endif
+      rgblight_set();
+    }
+  }
+  animation.last_timer = timer_read() - syncinfo->elapsed;
+  animation.pos = syncinfo->pos;
+  animation.increment = syncinfo->increment;
+
+  synced_config = rgblight_config.raw;
+  animation_restarted = false;
+}
+
 #ifdef RGBLIGHT_USE_TIMER
 
 // Animation timer -- AVR Timer3
@@ -768,25 +874,57 @@ void rgblight_task(void) {
 
 #endif /* RGBLIGHT_USE_TIMER */
 
+// Whether the running effect is due for its next step. Steps stay on a grid
+// of whole intervals instead of drifting with the scan rate, so halves that
+// start in step stay in step. After a stall the grid skips ahead.
+static inline bool rgblight_animation_due(uint16_t interval) {
+  uint16_t elapsed = timer_elapsed(animation.last_timer);
+  if (elapsed < interval) {
+    return false;
+  }
+  animation.last_timer += elapsed - elapsed % interval;
+  return true;
+}
+
 // Effects
 #ifdef RGBLIGHT_EFFECT_BREATHING
 __attribute__ ((weak))
 const uint8_t RGBLED_BREATHING_INTERVALS[] PROGMEM = {30, 20, 10, 5};
 
+// exp(sin(pos / 255 * pi)) - 1 in Q15 for the first half of a breath, the
+// second half mirrors it
+static const uint16_t RGBLED_BREATHING_CURVE[128] PROGMEM = {
+  0, 406, 817, 1233, 1655, 2081, 2512, 2948, 3388, 3834, 4285, 4740,
+  5200, 5665, 6135, 6610, 7089, 7573, 8061, 8554, 9052, 9553, 10060, 10570,
+  11085, 11604, 12127, 12654, 13185, 13719, 14258, 14800, 15345, 15894, 16447, 17002,
+  17561, 18122, 18686, 19253, 19823, 20395, 20969, 21546, 22124, 22704, 23286, 23870,
+  24454, 25040, 25627, 26214, 26802, 27391, 27980, 28569, 29157, 29745, 30333, 30920,
+  31506, 32090, 32673, 33254, 33834, 34411, 34986, 35558, 36128, 36694, 37257, 37817,
+  38372, 38924, 39471, 40014, 40552, 41085, 41612, 42134, 42651, 43161, 43665, 44162,
+  44653, 45136, 45612, 46081, 46542, 46995, 47439, 47876, 48303, 48722, 49131, 49531,
+  49921, 50302, 50672, 51033, 51383, 51722, 52050, 52367, 52674, 52968, 53252, 53523,
+  53783, 54031, 54266, 54489, 54700, 54898, 55084, 55257, 55417, 55564, 55697, 55818,
+  55925, 56020, 56100, 56168, 56222, 56262, 56289, 56303
+};
+
+// The constant parts of the curve, folded into Q15 integers at compile time
+#define BREATHE_ONE (1L << 15)
+#define BREATHE_CENTER ((int32_t)(RGBLIGHT_EFFECT_BREATHE_CENTER / M_E * BREATHE_ONE + 0.5))
+#define BREATHE_RANGE ((int32_t)((M_E - 1 / M_E) * BREATHE_ONE + 0.5))
+
 void rgblight_effect_breathing(uint8_t interval) {
-  static uint8_t pos = 0;
-  static uint16_t last_timer = 0;
-  float val;
+  uint8_t pos = animation.pos;
+  int32_t val;
 
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_BREATHING_INTERVALS[interval])) {
+  if (!rgblight_animation_due(pgm_read_byte(&RGBLED_BREATHING_INTERVALS[interval]))) {
     return;
   }
-  last_timer = timer_read();
 
   // http://sean.voisen.org/blog/2011/10/breathing-led-with-arduino/
-  val = (exp(sin((pos/255.0)*M_PI)) - RGBLIGHT_EFFECT_BREATHE_CENTER/M_E)*(RGBLIGHT_EFFECT_BREATHE_MAX/(M_E-1/M_E));
-  rgblight_sethsv_noeeprom_old(rgblight_config.hue, rgblight_config.sat, val);
-  pos = (pos + 1) % 256;
+  val = pgm_read_word(&RGBLED_BREATHING_CURVE[pos < 128 ? pos : 255 - pos]) + BREATHE_ONE - BREATHE_CENTER;
+  val = val * RGBLIGHT_EFFECT_BREATHE_MAX / BREATHE_RANGE;
+  rgblight_sethsv_noeeprom_old(rgblight_config.hue, rgblight_config.sat, val > 0 ? val : 0);
+  animation.pos = (pos + 1) % 256;
 }
 #endif
 
@@ -795,15 +933,13 @@ __attribute__ ((weak))
 const uint8_t RGBLED_RAINBOW_MOOD_INTERVALS[] PROGMEM = {120, 60, 30};
 
 void rgblight_effect_rainbow_mood(uint8_t interval) {
-  static uint16_t current_hue = 0;
-  static uint16_t last_timer = 0;
+  uint16_t current_hue = animation.pos;
 
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_RAINBOW_MOOD_INTERVALS[interval])) {
+  if (!rgblight_animation_due(pgm_read_byte(&RGBLED_RAINBOW_MOOD_INTERVALS[interval]))) {
     return;
   }
-  last_timer = timer_read();
   rgblight_sethsv_noeeprom_old(current_hue, rgblight_config.sat, rgblight_config.val);
-  current_hue = (current_hue + 1) % 360;
+  animation.pos = (current_hue + 1) % 360;
 }
 #endif
 
@@ -816,27 +952,30 @@ __attribute__ ((weak))
 const uint8_t RGBLED_RAINBOW_SWIRL_INTERVALS[] PROGMEM = {100, 50, 20};
 
 void rgblight_effect_rainbow_swirl(uint8_t interval) {
-  static uint16_t current_hue = 0;
-  static uint16_t last_timer = 0;
+  int16_t current_hue = animation.pos;
   uint16_t hue;
   uint8_t i;
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_RAINBOW_SWIRL_INTERVALS[interval / 2])) {
+  if (!rgblight_animation_due(pgm_read_byte(&RGBLED_RAINBOW_SWIRL_INTERVALS[interval / 2]))) {
     return;
   }
-  last_timer = timer_read();
+  hue = current_hue;
   for (i = 0; i < RGBLED_NUM; i++) {
-    hue = (RGBLIGHT_RAINBOW_SWIRL_RANGE / RGBLED_NUM * i + current_hue) % 360;
     sethsv(hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[i]);
+    // step to the next LED without a modulo per LED
+    hue += RGBLIGHT_RAINBOW_SWIRL_RANGE / RGBLED_NUM;
+    while (hue >= 360) {
+      hue -= 360;
+    }
   }
   rgblight_set();
 
   if (interval % 2) {
-    current_hue = (current_hue + 1) % 360;
+    animation.pos = (current_hue + 1) % 360;
   } else {
     if (current_hue - 1 < 0) {
-      current_hue = 359;
+      animation.pos = 359;
     } else {
-      current_hue = current_hue - 1;
+      animation.pos = current_hue - 1;
     }
   }
 }
@@ -847,30 +986,30 @@ __attribute__ ((weak))
 const uint8_t RGBLED_SNAKE_INTERVALS[] PROGMEM = {100, 50, 20};
 
 void rgblight_effect_snake(uint8_t interval) {
-  static uint8_t pos = 0;
-  static uint16_t last_timer = 0;
+  uint8_t pos = animation.pos;
   uint8_t i, j;
   int8_t k;
   int8_t increment = 1;
   if (interval % 2) {
     increment = -1;
   }
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_SNAKE_INTERVALS[interval / 2])) {
+  if (!rgblight_animation_due(pgm_read_byte(&RGBLED_SNAKE_INTERVALS[interval / 2]))) {
     return;
   }
-  last_timer = timer_read();
   for (i = 0; i < RGBLED_NUM; i++) {
     led[i].r = 0;
     led[i].g = 0;
     led[i].b = 0;
-    for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
-      k = pos + j * increment;
-      if (k < 0) {
-        k = k + RGBLED_NUM;
-      }
-      if (i == k) {
-        sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val*(RGBLIGHT_EFFECT_SNAKE_LENGTH-j)/RGBLIGHT_EFFECT_SNAKE_LENGTH), (LED_TYPE *)&led[i]);
-      }
+  }
+  // Light only the LEDs under the snake instead of searching the snake for
+  // every LED. The tail fades out by one step per segment.
+  for (j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
+    k = pos + j * increment;
+    if (k < 0) {
+      k = k + RGBLED_NUM;
+    }
+    if (k >= 0 && k < RGBLED_NUM) {
+      sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val*(RGBLIGHT_EFFECT_SNAKE_LENGTH-j)/RGBLIGHT_EFFECT_SNAKE_LENGTH), (LED_TYPE *)&led[k]);
     }
   }
   rgblight_set();
@@ -883,6 +1022,7 @@ void rgblight_effect_snake(uint8_t interval) {
   } else {
     pos = (pos + 1) % RGBLED_NUM;
   }
+  animation.pos = pos;
 }
 #endif
 
@@ -891,15 +1031,13 @@ __attribute__ ((weak))
 const uint8_t RGBLED_KNIGHT_INTERVALS[] PROGMEM = {127, 63, 31};
 
 void rgblight_effect_knight(uint8_t interval) {
-  static uint16_t last_timer = 0;
-  if (timer_elapsed(last_timer) < pgm_read_byte(&RGBLED_KNIGHT_INTERVALS[interval])) {
+  if (!rgblight_animation_due(pgm_read_byte(&RGBLED_KNIGHT_INTERVALS[interval]))) {
     return;
   }
-  last_timer = timer_read();
 
-  static int8_t low_bound = 0;
-  static int8_t high_bound = RGBLIGHT_EFFECT_KNIGHT_LENGTH - 1;
-  static int8_t increment = 1;
+  int8_t low_bound = animation.pos;
+  int8_t high_bound = low_bound + RGBLIGHT_EFFECT_KNIGHT_LENGTH - 1;
+  int8_t increment = animation.increment;
   uint8_t i, cur;
 
   // Set all the LEDs to 0
@@ -930,20 +1068,20 @@ void rgblight_effect_knight(uint8_t interval) {
   if (high_bound <= 0 || low_bound >= RGBLIGHT_EFFECT_KNIGHT_LED_NUM - 1) {
     increment = -increment;
   }
+  animation.pos = low_bound;
+  animation.increment = increment;
 }
 #endif
 
 #ifdef RGBLIGHT_EFFECT_CHRISTMAS
 void rgblight_effect_christmas(void) {
-  static uint16_t current_offset = 0;
-  static uint16_t last_timer = 0;
+  uint16_t current_offset;
   uint16_t hue;
   uint8_t i;
-  if (timer_elapsed(last_timer) < RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL) {
+  if (!rgblight_animation_due(RGBLIGHT_EFFECT_CHRISTMAS_INTERVAL)) {
     return;
   }
-  last_timer = timer_read();
-  current_offset = (current_offset + 1) % 2;
+  current_offset = animation.pos = (animation.pos + 1) % 2;
   for (i = 0; i < RGBLED_NUM; i++) {
     hue = 0 + ((i/RGBLIGHT_EFFECT_CHRISTMAS_STEP + current_offset) % 2) * 120;
     sethsv(hue, rgblight_config.sat, rgblight_config.val, (LED_TYPE *)&led[i]);
@@ -957,12 +1095,10 @@ __attribute__ ((weak))
 const uint16_t RGBLED_RGBTEST_INTERVALS[] PROGMEM = {1024};
 
 void rgblight_effect_rgbtest(void) {
-  static uint8_t pos = 0;
-  static uint16_t last_timer = 0;
   static uint8_t maxval = 0;
   uint8_t g; uint8_t r; uint8_t b;
 
-  if (timer_elapsed(last_timer) < pgm_read_word(&RGBLED_RGBTEST_INTERVALS[0])) {
+  if (!rgblight_animation_due(pgm_read_word(&RGBLED_RGBTEST_INTERVALS[0]))) {
     return;
   }
 
@@ -971,26 +1107,23 @@ void rgblight_effect_rgbtest(void) {
       sethsv(0, 255, RGBLIGHT_LIMIT_VAL, &tmp_led);
       maxval = tmp_led.r;
   }
-  last_timer = timer_read();
   g = r = b = 0;
-  switch( pos ) {
+  switch( animation.pos ) {
     case 0: r = maxval; break;
     case 1: g = maxval; break;
     case 2: b = maxval; break;
   }
   rgblight_setrgb(r, g, b);
-  pos = (pos + 1) % 3;
+  animation.pos = (animation.pos + 1) % 3;
 }
 #endif
 
 #ifdef RGBLIGHT_EFFECT_ALTERNATING
 void rgblight_effect_alternating(void){
-  static uint16_t last_timer = 0;
-  static uint16_t pos = 0;
-  if (timer_elapsed(last_timer) < 500) {
+  uint16_t pos = animation.pos;
+  if (!rgblight_animation_due(500)) {
     return;
   }
-  last_timer = timer_read();
 
   for(int i = 0; i<RGBLED_NUM; i++){
       if(i<RGBLED_NUM/2 && pos){
@@ -1002,6 +1135,6 @@ void rgblight_effect_alternating(void){
       }
   }
   rgblight_set();
-  pos = (pos + 1) % 2;
+  animation.pos = (pos + 1) % 2;
 }
 #endif
@@ -174,6 +174,7 @@ void rgblight_step_reverse(void);
 uint8_t rgblight_get_mode(void);
 void rgblight_mode(uint8_t mode);
 void rgblight_set(void);
+void rgblight_set_full(void);
 void rgblight_update_dword(uint32_t dword);
 void rgblight_increase_hue(void);
 void rgblight_decrease_hue(void);
@@ -197,6 +198,30 @@ void rgblight_setrgb_slave(uint8_t r, uint8_t g, uint8_t b);
 void rgblight_sethsv_master(uint16_t hue, uint8_t sat, uint8_t val);
 void rgblight_sethsv_slave(uint16_t hue, uint8_t sat, uint8_t val);
 
+// Everything a split slave needs to show the same lighting as its master,
+// animation phase included. Sent as is, so it is packed.
+typedef struct __attribute__((packed)) {
+  uint32_t config;  // rgblight_config_t.raw
+  uint16_t elapsed; // since the animation last stepped
+  int16_t  pos;
+  int8_t   increment;
+} rgblight_syncinfo_t;
+
+// True when the config or the animation changed since the last syncinfo
+bool rgblight_sync_pending(void);
+void rgblight_get_syncinfo(rgblight_syncinfo_t *syncinfo);
+// Takes over the master's state without touching EEPROM
+void rgblight_update_sync(const rgblight_syncinfo_t *syncinfo);
+
+typedef struct {
+  uint32_t frames_sent;
+  uint32_t frames_skipped; // nothing changed since the last frame
+  uint32_t leds_sent;
+} rgblight_stats_t;
+
+void rgblight_get_stats(rgblight_stats_t *stats);
+void rgblight_reset_stats(void);
+
 uint32_t eeconfig_read_rgblight(void);
 void eeconfig_update_rgblight(uint32_t val);
 void eeconfig_update_rgblight_default(void);
@@ -26,6 +26,7 @@ SOFTWARE.
 #include "serial_link/protocol/frame_validator.h"
 #include "serial_link/protocol/physical.h"
 #include <stdbool.h>
+#include <stddef.h>
 
 // This implements the "Consistent overhead byte stuffing protocol"
 // https://en.wikipedia.org/wiki/Consistent_Overhead_Byte_Stuffing
@@ -35,7 +36,10 @@ typedef struct byte_stuffer_state {
     uint16_t next_zero;
     uint16_t data_pos;
     bool long_frame;
-    uint8_t data[MAX_FRAME_SIZE];
+    uint32_t crc;
+    // The driver reads raw bytes to the end of the frame so far, and they
+    // are unstuffed in place, so the buffer has some room to spare
+    uint8_t data[MAX_FRAME_SIZE + BYTE_STUFFER_RECV_SLACK];
 }byte_stuffer_state_t;
 
 static byte_stuffer_state_t states[NUM_LINKS];
@@ -44,6 +48,7 @@ void init_byte_stuffer_state(byte_stuffer_state_t* state) {
     state->next_zero = 0;
     state->data_pos = 0;
     state->long_frame = false;
+    state->crc = VALIDATOR_CRC_INIT;
 }
 
 void init_byte_stuffer(void) {
@@ -53,13 +58,22 @@ void init_byte_stuffer(void) {
     }
 }
 
-void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
-    byte_stuffer_state_t* state = &states[link];
+static void start_frame(byte_stuffer_state_t* state, uint8_t data) {
+    state->next_zero = data;
+    state->long_frame = data == 0xFF;
+    state->data_pos = 0;
+    state->crc = VALIDATOR_CRC_INIT;
+}
+
+static void append_byte(byte_stuffer_state_t* state, uint8_t data) {
+    state->data[state->data_pos++] = data;
+    state->crc = validator_crc_update(state->crc, &data, 1);
+}
+
+static void recv_code_or_zero(uint8_t link, byte_stuffer_state_t* state, uint8_t data) {
     // Start of a new frame
     if (state->next_zero == 0) {
-        state->next_zero = data;
-        state->long_frame = data == 0xFF;
-        state->data_pos = 0;
+        start_frame(state, data);
         return;
     }
 
@@ -68,7 +82,7 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
         if (state->next_zero == 0) {
             // The frame is completed
             if (state->data_pos > 0) {
-                validator_recv_frame(link, state->data, state->data_pos);
+                validator_recv_frame_crc(link, state->data, state->data_pos, state->crc);
             }
         }
         else {
@@ -80,63 +94,128 @@ void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
         if (state->data_pos == MAX_FRAME_SIZE) {
             // We exceeded our maximum frame size
             // therefore there's nothing else to do than reset to a new frame
-            state->next_zero = data;
-            state->long_frame = data == 0xFF;
-            state->data_pos = 0;
+            start_frame(state, data);
         }
         else if (state->next_zero == 0) {
-            if (state->long_frame) {
-                // This is part of a long frame, so continue
-                state->next_zero = data;
-                state->long_frame = data == 0xFF;
-            }
-            else {
+            if (!state->long_frame) {
                 // Special case for zeroes
-                state->next_zero = data;
-                state->data[state->data_pos++] = 0;
+                append_byte(state, 0);
             }
+            // This is the code of the next block
+            state->next_zero = data;
+            state->long_frame = data == 0xFF;
         }
         else {
-            state->data[state->data_pos++] = data;
+            append_byte(state, data);
         }
     }
 }
 
-static void send_block(uint8_t link, uint8_t* start, uint8_t* end, uint8_t num_non_zero) {
-    send_data(link, &num_non_zero, 1);
-    if (end > start) {
-        send_data(link, start, end-start);
+uint8_t* byte_stuffer_recv_buffer(uint8_t link, uint16_t* size) {
+    byte_stuffer_state_t* state = &states[link];
+    *size = sizeof(state->data) - state->data_pos;
+    return state->data + state->data_pos;
+}
+
+void byte_stuffer_recv_data(uint8_t link, uint16_t size) {
+    byte_stuffer_state_t* state = &states[link];
+    const uint8_t* raw = state->data + state->data_pos;
+    const uint8_t* end = raw + size;
+
+    // The frame never catches up with the raw bytes, as every code takes a
+    // byte and gives back at most one zero
+    while (raw < end) {
+        // Copy the data up to the next code down in one go
+        uint16_t run = state->next_zero > 1 ? state->next_zero - 1 : 0;
+        if (run > end - raw) {
+            run = end - raw;
+        }
+        if (run > MAX_FRAME_SIZE - state->data_pos) {
+            run = MAX_FRAME_SIZE - state->data_pos;
+        }
+        uint8_t* frame = state->data + state->data_pos;
+        uint16_t n = 0;
+        while (n < run && raw[n] != 0) {
+            frame[n] = raw[n];
+            n++;
+        }
+        if (n > 0) {
+            state->crc = validator_crc_update(state->crc, frame, n);
+            state->data_pos += n;
+            state->next_zero -= n;
+            raw += n;
+            continue;
+        }
+        // Codes, the end of the frame, and anything unexpected
+        recv_code_or_zero(link, state, *raw++);
+    }
+}
+
+void byte_stuffer_recv_byte(uint8_t link, uint8_t data) {
+    uint16_t size;
+    *byte_stuffer_recv_buffer(link, &size) = data;
+    byte_stuffer_recv_data(link, 1);
+}
+
+// Puts the zeroes back that carried the codes of the blocks after the
+// first one, which starts at start and has the given code
+static void restore_zeroes(uint8_t* start, uint16_t size, uint8_t code) {
+    uint16_t pos = code - 1;
+    while (code != 0xFF && pos < size) {
+        code = start[pos];
+        start[pos] = 0;
+        pos += code;
     }
 }
 
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size) {
     const uint8_t zero = 0;
     if (size > 0) {
-        uint16_t num_non_zero = 1;
+        // Each block's code goes where the zero ending the block before it
+        // was, so the frame goes out in place, in as few pieces as the
+        // blocks of 254 non-zeroes allow. The zeroes are put back afterwards.
         uint8_t* end = data + size;
-        uint8_t* start = data;
-        while (data < end) {
-            if (num_non_zero == 0xFF) {
-                // There's more data after big non-zero block
-                // So send it, and start a new block
-                send_block(link, start, data, num_non_zero);
-                start = data;
-                num_non_zero = 1;
+        uint8_t* block = data;
+        uint8_t* slot = NULL;
+        uint8_t* pending = data;
+        uint8_t pending_code = 0;
+        while (true) {
+            uint16_t left = end - block;
+            uint8_t max = left < 0xFE ? left : 0xFE;
+            uint8_t num_non_zero = 0;
+            while (num_non_zero < max && block[num_non_zero] != 0) {
+                num_non_zero++;
+            }
+            uint8_t code = num_non_zero + 1;
+            if (slot) {
+                *slot = code;
             }
             else {
-                if (*data == 0) {
-                    // A zero encountered, so send the block
-                    send_block(link, start, data, num_non_zero);
-                    start = data + 1;
-                    num_non_zero = 1;
-                }
-                else {
-                    num_non_zero++;
+                // Nowhere to put the code, so send it on its own
+                if (block > pending) {
+                    send_data(link, pending, block - pending);
+                    restore_zeroes(pending, block - pending, pending_code);
                 }
-                ++data;
+                send_data(link, &code, 1);
+                pending = block;
+                pending_code = code;
+            }
+
+            if (block + num_non_zero == end) {
+                break;
+            }
+            else if (code == 0xFF) {
+                // There's more data after big non-zero block
+                slot = NULL;
+                block += num_non_zero;
+            }
+            else {
+                slot = block + num_non_zero;
+                block = slot + 1;
             }
         }
-        send_block(link, start, data, num_non_zero);
+        send_data(link, pending, end - pending);
+        restore_zeroes(pending, end - pending, pending_code);
         send_data(link, &zero, 1);
     }
 }
@@ -29,9 +29,17 @@ SOFTWARE.
 
 #define MAX_FRAME_SIZE 1024
 #define NUM_LINKS 2
+// The least the driver can read to the receive buffer at a time
+#define BYTE_STUFFER_RECV_SLACK 16
 
 void init_byte_stuffer(void);
 void byte_stuffer_recv_byte(uint8_t link, uint8_t data);
+// The driver can read straight into the receive buffer, which returns where
+// to put the bytes and how many fit, then hand them over to be unstuffed in
+// place
+uint8_t* byte_stuffer_recv_buffer(uint8_t link, uint16_t* size);
+void byte_stuffer_recv_data(uint8_t link, uint16_t size);
+// The frame is stuffed in place while it is sent, and left as it was
 void byte_stuffer_send_frame(uint8_t link, uint8_t* data, uint16_t size);
 
 #endif
@@ -0,0 +1,48 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 agent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#ifndef SERIAL_LINK_CRC32_H
+#define SERIAL_LINK_CRC32_H
+
+#include <stdint.h>
+
+// CRC32 kernels for the frame validator. They all run the reflected
+// CRC-32 (IEEE 802.3) register, without the final xor, so they produce
+// the same checksums and any of them can continue what another started.
+//
+// Pick one with SERIAL_LINK_CRC in config.h, the default is the byte table
+#define SERIAL_LINK_CRC_TABLE    0 // a byte at a time, 1 KB of tables
+#define SERIAL_LINK_CRC_SLICE4   1 // four bytes at a time, 4 KB of tables
+#define SERIAL_LINK_CRC_SLICE8   2 // eight bytes at a time, 8 KB of tables
+#define SERIAL_LINK_CRC_NIBBLE   3 // four bits at a time, 64 bytes of tables
+#define SERIAL_LINK_CRC_HARDWARE 4 // the MCU's CRC unit
+
+uint32_t crc32_table_update(uint32_t crc, const uint8_t* data, uint16_t size);
+uint32_t crc32_slice4_update(uint32_t crc, const uint8_t* data, uint16_t size);
+uint32_t crc32_slice8_update(uint32_t crc, const uint8_t* data, uint16_t size);
+uint32_t crc32_nibble_update(uint32_t crc, const uint8_t* data, uint16_t size);
+// Provided by the platform, see system/crc32_stm32.c
+uint32_t crc32_hardware_update(uint32_t crc, const uint8_t* data, uint16_t size);
+
+#endif
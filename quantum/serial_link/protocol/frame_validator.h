@@ -27,7 +27,17 @@ SOFTWARE.
 
 #include <stdint.h>
 
+// The CRC32 is run over the frame one piece at a time, starting from
+// VALIDATOR_CRC_INIT. Over a whole frame, its checksum included, it ends
+// up at VALIDATOR_CRC_RESIDUE when the frame is intact.
+#define VALIDATOR_CRC_INIT 0xFFFFFFFF
+#define VALIDATOR_CRC_RESIDUE 0xDEBB20E3
+
+uint32_t validator_crc_update(uint32_t crc, const uint8_t* data, uint16_t size);
+
 void validator_recv_frame(uint8_t link, uint8_t* data, uint16_t size);
+// For a receiver that already ran the CRC over the frame
+void validator_recv_frame_crc(uint8_t link, uint8_t* data, uint16_t size, uint32_t crc);
 // The buffer pointed to by the data needs 4 additional bytes
 void validator_send_frame(uint8_t link, uint8_t* data, uint16_t size);
 
@@ -46,6 +46,11 @@ void triple_buffer_init(triple_buffer_object_t* object) {
 }
 
 void* triple_buffer_read_internal(uint16_t object_size, triple_buffer_object_t* object) {
+    // Only the reader takes the data away, so when there's none there's
+    // nothing to swap, and no need to lock
+    if (!(GET_DATA_AVAILABLE())) {
+        return NULL;
+    }
     serial_link_lock();
     if (GET_DATA_AVAILABLE()) {
         uint8_t shared_index = GET_SHARED_INDEX();
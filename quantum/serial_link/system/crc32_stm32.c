@@ -0,0 +1,61 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 agent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "serial_link/protocol/crc32.h"
+
+#if defined(SERIAL_LINK_CRC) && SERIAL_LINK_CRC == SERIAL_LINK_CRC_HARDWARE
+
+#include "hal.h"
+
+// The unit needs a programmable initial value and bit reversal to run the
+// reflected register, which the STM32F0, F3, F7 and L4 families have
+#if !defined(CRC_CR_REV_IN_0) || !defined(CRC_CR_REV_OUT)
+#error "This MCU has no suitable CRC unit, choose another SERIAL_LINK_CRC"
+#endif
+
+static bool crc_clock_enabled = false;
+
+uint32_t crc32_hardware_update(uint32_t crc, const uint8_t* data, uint16_t size) {
+    if (!crc_clock_enabled) {
+#if defined(RCC_AHBENR_CRCEN)
+        RCC->AHBENR |= RCC_AHBENR_CRCEN;
+#else
+        RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+#endif
+        crc_clock_enabled = true;
+    }
+    // The unit shifts the other way, so the register goes in and comes out
+    // bit reversed. It is shared by the sending and the receiving thread.
+    chSysLock();
+    CRC->INIT = __RBIT(crc);
+    CRC->CR = CRC_CR_REV_IN_0 | CRC_CR_REV_OUT | CRC_CR_RESET;
+    while (size-- != 0) {
+        *(volatile uint8_t*)&CRC->DR = *data++;
+    }
+    crc = CRC->DR;
+    chSysUnlock();
+    return crc;
+}
+
+#endif
@@ -26,6 +26,9 @@ SOFTWARE.
 #include "gmock/gmock.h"
 #include <vector>
 #include <algorithm>
+#include <chrono>
+#include <random>
+#include <stdio.h>
 extern "C" {
 #include "serial_link/protocol/byte_stuffer.h"
 #include "serial_link/protocol/frame_validator.h"
@@ -51,8 +54,25 @@ public:
 
     void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
         std::copy(data, data + size, std::back_inserter(sent_data));
+        send_calls++;
     }
     std::vector<uint8_t> sent_data;
+    int send_calls = 0;
+
+    // Hands the bytes over the way the driver does, read straight into the
+    // receive buffer in chunks of up to chunk_size
+    void receive_in_place(uint8_t link, const std::vector<uint8_t>& data, uint16_t chunk_size) {
+        size_t pos = 0;
+        while (pos < data.size()) {
+            uint16_t size;
+            uint8_t* buffer = byte_stuffer_recv_buffer(link, &size);
+            EXPECT_GE(size, BYTE_STUFFER_RECV_SLACK);
+            size = std::min<size_t>({size, chunk_size, data.size() - pos});
+            std::copy(data.begin() + pos, data.begin() + pos + size, buffer);
+            byte_stuffer_recv_data(link, size);
+            pos += size;
+        }
+    }
 
     static ByteStuffer* Instance;
 };
@@ -64,6 +84,15 @@ extern "C" {
         ByteStuffer::Instance->validator_recv_frame(link, data, size);
     }
 
+    // The CRC is the validator's business
+    void validator_recv_frame_crc(uint8_t link, uint8_t* data, uint16_t size, uint32_t crc) {
+        ByteStuffer::Instance->validator_recv_frame(link, data, size);
+    }
+
+    uint32_t validator_crc_update(uint32_t crc, const uint8_t* data, uint16_t size) {
+        return crc;
+    }
+
     void send_data(uint8_t link, const uint8_t* data, uint16_t size) {
         ByteStuffer::Instance->send_data(link, data, size);
     }
@@ -481,3 +510,100 @@ TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_254_bytes_and_then_zero) {
        byte_stuffer_recv_byte(1, d);
     }
 }
+
+TEST_F(ByteStuffer, sends_and_receives_full_roundtrip_zero_then_254_bytes) {
+    uint8_t original_data[257];
+    int i;
+    original_data[0] = 0;
+    for(i=1;i<255;i++) {
+        original_data[i] = i;
+    }
+    original_data[255] = 5;
+    original_data[256] = 6;
+    byte_stuffer_send_frame(0, original_data, sizeof(original_data));
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+        .With(Args<1, 2>(ElementsAreArray(original_data)));
+    for(auto& d : sent_data) {
+       byte_stuffer_recv_byte(1, d);
+    }
+}
+
+TEST_F(ByteStuffer, sends_frame_in_one_piece_and_leaves_it_as_it_was) {
+    uint8_t original_data[] = {0, 7, 0, 0, 3, 4, 0, 9};
+    uint8_t data[sizeof(original_data)];
+    std::copy(original_data, original_data + sizeof(original_data), data);
+    byte_stuffer_send_frame(0, data, sizeof(data));
+    uint8_t expected[] = {1, 2, 7, 1, 3, 3, 4, 2, 9, 0};
+    EXPECT_THAT(sent_data, ElementsAreArray(expected));
+    // the first code, the frame, and the end of it
+    EXPECT_EQ(send_calls, 3);
+    EXPECT_THAT(data, ElementsAreArray(original_data));
+}
+
+TEST_F(ByteStuffer, sends_frame_with_long_blocks_and_leaves_it_as_it_was) {
+    uint8_t original_data[600];
+    int i;
+    for(i=0;i<600;i++) {
+        original_data[i] = i % 300 == 0 || i == 599 ? 0 : i % 7 + 1;
+    }
+    uint8_t data[sizeof(original_data)];
+    std::copy(original_data, original_data + sizeof(original_data), data);
+    byte_stuffer_send_frame(0, data, sizeof(data));
+    EXPECT_THAT(data, ElementsAreArray(original_data));
+
+    EXPECT_CALL(*this, validator_recv_frame(_, _, _))
+        .With(Args<1, 2>(ElementsAreArray(original_data)));
+    for(auto& d : sent_data) {
+       byte_stuffer_recv_byte(1, d);
+    }
+}
+
+TEST_F(ByteStuffer, receives_frames_read_in_place_in_chunks) {
+    std::mt19937 random(1234);
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 20; i++) {
+        std::vector<uint8_t> frame(1 + random() % MAX_FRAME_SIZE);
+        for (auto& d : frame) {
+            d = random() % 4 == 0 ? 0 : random();
+        }
+        byte_stuffer_send_frame(0, frame.data(), frame.size());
+        frames.push_back(frame);
+    }
+
+    for (uint16_t chunk_size : {1, 7, 16, 2000}) {
+        testing::InSequence sequence;
+        for (auto& frame : frames) {
+            EXPECT_CALL(*this, validator_recv_frame(1, _, _))
+                .With(Args<1, 2>(ElementsAreArray(frame)));
+        }
+        receive_in_place(1, sent_data, chunk_size);
+        testing::Mock::VerifyAndClearExpectations(this);
+    }
+}
+
+TEST_F(ByteStuffer, throughput_benchmark) {
+    const int num_frames = 2000;
+    const int frame_size = 1000;
+    std::mt19937 random(42);
+    std::vector<uint8_t> frame(frame_size);
+    for (auto& d : frame) {
+        d = random() % 16 == 0 ? 0 : random();
+    }
+
+    sent_data.reserve(num_frames * (frame_size + frame_size / 254 + 2));
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_frames; i++) {
+        byte_stuffer_send_frame(0, frame.data(), frame.size());
+    }
+    auto sent = std::chrono::steady_clock::now();
+
+    EXPECT_CALL(*this, validator_recv_frame(_, _, frame_size))
+        .Times(num_frames);
+    receive_in_place(1, sent_data, 512);
+    auto received = std::chrono::steady_clock::now();
+
+    auto mb_per_s = [&](std::chrono::steady_clock::duration time) {
+        return num_frames * frame_size / std::chrono::duration<double, std::micro>(time).count();
+    };
+    printf("stuffing %.1f MB/s, unstuffing %.1f MB/s\n", mb_per_s(sent - start), mb_per_s(received - sent));
+}
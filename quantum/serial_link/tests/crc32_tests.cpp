@@ -0,0 +1,135 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2026 agent
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*/
+
+#include "gtest/gtest.h"
+#include <vector>
+#include <chrono>
+#include <random>
+#include <string.h>
+extern "C" {
+#include "serial_link/protocol/crc32.h"
+#include "serial_link/protocol/frame_validator.h"
+}
+
+typedef uint32_t (*crc32_kernel_t)(uint32_t crc, const uint8_t* data, uint16_t size);
+
+struct Kernel {
+    const char* name;
+    crc32_kernel_t update;
+};
+
+// The hardware kernel can only run on the target
+static const Kernel kernels[] = {
+    {"table", crc32_table_update},
+    {"slice4", crc32_slice4_update},
+    {"slice8", crc32_slice8_update},
+    {"nibble", crc32_nibble_update},
+};
+
+// One bit at a time, straight from the polynomial
+static uint32_t reference_update(uint32_t crc, const uint8_t* data, uint16_t size) {
+    while (size-- != 0) {
+        crc ^= *data++;
+        for (int i = 0; i < 8; i++) {
+            crc = (crc >> 1) ^ (crc & 1 ? 0xEDB88320 : 0);
+        }
+    }
+    return crc;
+}
+
+static std::vector<uint8_t> random_data(size_t size) {
+    std::mt19937 random(size);
+    std::vector<uint8_t> data(size);
+    for (auto& d : data) {
+        d = random();
+    }
+    return data;
+}
+
+TEST(Crc32, computes_the_check_value) {
+    const char* check = "123456789";
+    for (auto& kernel : kernels) {
+        uint32_t crc = kernel.update(VALIDATOR_CRC_INIT, (const uint8_t*)check, 9);
+        EXPECT_EQ(~crc, 0xCBF43926) << kernel.name;
+    }
+}
+
+TEST(Crc32, kernels_agree_on_every_size_and_alignment) {
+    std::vector<uint8_t> data = random_data(300);
+    for (auto& kernel : kernels) {
+        for (uint16_t offset = 0; offset < 8; offset++) {
+            for (uint16_t size = 0; size + offset <= data.size(); size++) {
+                ASSERT_EQ(kernel.update(VALIDATOR_CRC_INIT, data.data() + offset, size),
+                          reference_update(VALIDATOR_CRC_INIT, data.data() + offset, size))
+                    << kernel.name << ", offset " << offset << ", size " << size;
+            }
+        }
+    }
+}
+
+TEST(Crc32, kernels_continue_each_others_crc) {
+    std::vector<uint8_t> data = random_data(100);
+    uint32_t expected = reference_update(VALIDATOR_CRC_INIT, data.data(), data.size());
+    for (auto& first : kernels) {
+        for (auto& second : kernels) {
+            for (uint16_t split = 0; split <= data.size(); split += 7) {
+                uint32_t crc = first.update(VALIDATOR_CRC_INIT, data.data(), split);
+                crc = second.update(crc, data.data() + split, data.size() - split);
+                ASSERT_EQ(crc, expected) << first.name << " then " << second.name << " at " << split;
+            }
+        }
+    }
+}
+
+TEST(Crc32, frame_with_its_checksum_leaves_the_residue) {
+    std::vector<uint8_t> data = random_data(61);
+    for (auto& kernel : kernels) {
+        std::vector<uint8_t> frame = data;
+        uint32_t crc = ~kernel.update(VALIDATOR_CRC_INIT, frame.data(), frame.size());
+        frame.resize(frame.size() + 4);
+        memcpy(frame.data() + data.size(), &crc, 4);
+        EXPECT_EQ(kernel.update(VALIDATOR_CRC_INIT, frame.data(), frame.size()), VALIDATOR_CRC_RESIDUE) << kernel.name;
+    }
+}
+
+TEST(Crc32, throughput_benchmark) {
+    const int num_frames = 5000;
+    const int frame_size = 1024;
+    std::vector<uint8_t> frame = random_data(frame_size);
+    uint32_t expected = 0;
+    for (int i = 0; i < num_frames; i++) {
+        expected = reference_update(expected, frame.data(), frame_size);
+    }
+
+    for (auto& kernel : kernels) {
+        uint32_t crc = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < num_frames; i++) {
+            crc = kernel.update(crc, frame.data(), frame_size);
+        }
+        auto time = std::chrono::steady_clock::now() - start;
+        EXPECT_EQ(crc, expected) << kernel.name;
+        printf("%s %.1f MB/s\n", kernel.name, num_frames * frame_size / std::chrono::duration<double, std::micro>(time).count());
+    }
+}
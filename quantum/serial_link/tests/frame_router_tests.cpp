@@ -25,6 +25,9 @@ SOFTWARE.
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <array>
+#include <chrono>
+#include <random>
+#include <stdio.h>
 extern "C" {
     #include "serial_link/protocol/transport.h"
     #include "serial_link/protocol/byte_stuffer.h"
@@ -227,3 +230,56 @@ TEST_F(FrameRouter, master_receives_on_uplink_does_nothing) {
     EXPECT_EQ(router_buffers[0].send_buffers[UP_LINK].size(), 0);
     EXPECT_EQ(router_buffers[0].send_buffers[DOWN_LINK].size(), 0);
 }
+
+TEST_F(FrameRouter, corrupted_frame_is_dropped) {
+    frame_buffer_t data;
+    data.data = {0xAB, 0x70, 0x55, 0xBB};
+    activate_router(1);
+    router_send_frame(0, (uint8_t*)&data, 4);
+    router_buffers[1].send_buffers[UP_LINK][2] ^= 0x10;
+
+    EXPECT_CALL(*this, transport_recv_frame(_, _, _))
+        .Times(0);
+    simulate_transport(1, 0);
+}
+
+TEST_F(FrameRouter, throughput_benchmark) {
+    const int num_frames = 1000;
+    const int frame_size = 1000;
+    std::mt19937 random(42);
+    // room for the destination and the CRC
+    std::vector<uint8_t> frame(frame_size + 5);
+    for (auto& d : frame) {
+        d = random() % 16 == 0 ? 0 : random();
+    }
+    std::vector<uint8_t> original(frame.begin(), frame.begin() + frame_size);
+
+    activate_router(1);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_frames; i++) {
+        router_send_frame(0, frame.data(), frame_size);
+    }
+    auto sent = std::chrono::steady_clock::now();
+
+    EXPECT_CALL(*this, transport_recv_frame(1, _, _))
+        .With(Args<1, 2>(ElementsAreArray(original)))
+        .Times(num_frames);
+    activate_router(0);
+    // read in place, the way the driver does
+    auto& stream = router_buffers[1].send_buffers[UP_LINK];
+    size_t pos = 0;
+    while (pos < stream.size()) {
+        uint16_t size;
+        uint8_t* buffer = byte_stuffer_recv_buffer(DOWN_LINK, &size);
+        size = std::min<size_t>(size, stream.size() - pos);
+        std::copy(stream.begin() + pos, stream.begin() + pos + size, buffer);
+        byte_stuffer_recv_data(DOWN_LINK, size);
+        pos += size;
+    }
+    auto received = std::chrono::steady_clock::now();
+
+    auto mb_per_s = [&](std::chrono::steady_clock::duration time) {
+        return num_frames * frame_size / std::chrono::duration<double, std::micro>(time).count();
+    };
+    printf("sending %.1f MB/s, receiving %.1f MB/s\n", mb_per_s(sent - start), mb_per_s(received - sent));
+}
@@ -4,12 +4,18 @@ serial_link_byte_stuffer_SRC :=\
 
 serial_link_frame_validator_SRC := \
 	$(SERIAL_PATH)/tests/frame_validator_tests.cpp \
-	$(SERIAL_PATH)/protocol/frame_validator.c 
+	$(SERIAL_PATH)/protocol/frame_validator.c \
+	$(SERIAL_PATH)/protocol/crc32.c
+
+serial_link_crc32_SRC := \
+	$(SERIAL_PATH)/tests/crc32_tests.cpp \
+	$(SERIAL_PATH)/protocol/crc32.c
 
 serial_link_frame_router_SRC := \
 	$(SERIAL_PATH)/tests/frame_router_tests.cpp \
 	$(SERIAL_PATH)/protocol/byte_stuffer.c \
 	$(SERIAL_PATH)/protocol/frame_validator.c \
+	$(SERIAL_PATH)/protocol/crc32.c \
 	$(SERIAL_PATH)/protocol/frame_router.c
 
 serial_link_triple_buffered_object_SRC := \
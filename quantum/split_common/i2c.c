@@ -18,6 +18,7 @@
 #define BUFFER_POS_INC() (slave_buffer_pos = (slave_buffer_pos+1)%SLAVE_BUFFER_SIZE)
 
 volatile uint8_t i2c_slave_buffer[SLAVE_BUFFER_SIZE];
+volatile uint8_t i2c_slave_written[(SLAVE_BUFFER_SIZE + 7) / 8];
 
 static volatile uint8_t slave_buffer_pos;
 static volatile bool slave_has_register_set = false;
@@ -155,10 +156,11 @@ ISR(TWI_vect) {
         slave_has_register_set = true;
       } else {      
         i2c_slave_buffer[slave_buffer_pos] = TWDR;
+        i2c_slave_written[slave_buffer_pos >> 3] |= 1 << (slave_buffer_pos & 7);
         
         if ( slave_buffer_pos == I2C_BACKLIT_START) {
             BACKLIT_DIRTY = true;
-        } else if ( slave_buffer_pos == (I2C_RGB_START+3)) {
+        } else if ( slave_buffer_pos == (I2C_RGB_START+I2C_RGB_SIZE-1)) {
             RGB_DIRTY = true;
         }
         
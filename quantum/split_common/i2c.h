@@ -14,22 +14,26 @@
 
 // Address location defines (Keymap should be last, as it's size is dynamic)
 #define I2C_BACKLIT_START   0x00
-// Need 4 bytes for RGB (32 bit)
+// Need 9 bytes for RGB (rgblight_syncinfo_t)
 #define I2C_RGB_START       0x01
-#define I2C_KEYMAP_START    0x06
+#define I2C_RGB_SIZE        9
+#define I2C_KEYMAP_START    0x0A
 
 // Slave buffer (8bit per)
-// Rows per hand + backlit space + rgb space
-// TODO : Make this dynamically sized
-#define SLAVE_BUFFER_SIZE 0x20
+// Backlit space + rgb space + the matrix, then transport channels
+#ifndef SLAVE_BUFFER_SIZE
+#define SLAVE_BUFFER_SIZE 0x40
+#endif
 
 // i2c SCL clock frequency
 #ifndef SCL_CLOCK
 #define SCL_CLOCK  100000L
 #endif
 
-// Support 8bits right now (8 cols) will need to edit to take higher (code exists in delta split?)
+// The keymap area holds the other half's matrix packed by transport.c
 extern volatile uint8_t i2c_slave_buffer[SLAVE_BUFFER_SIZE];
+// One bit per slave buffer byte, set when the master writes it
+extern volatile uint8_t i2c_slave_written[(SLAVE_BUFFER_SIZE + 7) / 8];
 
 void i2c_master_init(void);
 uint8_t i2c_master_start(uint8_t address);
@@ -29,6 +29,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "quantum.h"
 #include "debounce.h"
 #include "transport.h"
+#include "split_state.h"
 
 #if (MATRIX_COLS <= 8)
 #  define print_matrix_header() print("\nr/c 01234567\n")
@@ -305,6 +306,7 @@ uint8_t matrix_scan(void) {
   if (is_keyboard_master()) {
     static uint8_t error_count;
 
+    split_state_update();
     if (!transport_master(matrix + thatHand)) {
       error_count++;
 
@@ -178,6 +178,7 @@
 
 static SSTD_t *Transaction_table = NULL;
 static uint8_t Transaction_table_size = 0;
+static volatile uint8_t parity_errors = 0;
 
 inline static void serial_delay(void) ALWAYS_INLINE;
 inline static
@@ -342,6 +343,7 @@ uint8_t serial_recive_packet(uint8_t *buffer, uint8_t size) {
     data = serial_read_chunk(&pecount, 8);
     buffer[i] = data;
   }
+  parity_errors += pecount;
   return pecount == 0;
 }
 
@@ -385,6 +387,7 @@ ISR(SERIAL_PIN_INTERRUPT) {
   bits = serial_read_chunk(&pecount,7);
   tid = bits>>3;
   bits = (bits&7) != nibble_bits_count(tid);
+  parity_errors += pecount;
   if( bits || pecount> 0 || tid > Transaction_table_size ) {
       return;
   }
@@ -529,6 +532,14 @@ int soft_serial_get_and_clean_status(int sstd_index) {
 }
 #endif
 
+int soft_serial_get_and_clean_parity_errors(void) {
+    cli();
+    int retval = parity_errors;
+    parity_errors = 0;
+    sei();
+    return retval;
+}
+
 #endif
 
 // Helix serial.c history
@@ -14,13 +14,15 @@
 //                                               //  4: about 26kbps
 //                                               //  5: about 20kbps
 //
-// //// USE simple API (using signle-type transaction function)
-//   /* nothing */
-// //// USE flexible API (using multi-type transaction function)
-//   #define SERIAL_USE_MULTI_TRANSACTION
+// split_common's transport always uses the flexible API
+// (multi-type transaction function)
 //
 // /////////////////////////////////////////////////////////////////
 
+#ifndef SERIAL_USE_MULTI_TRANSACTION
+#  define SERIAL_USE_MULTI_TRANSACTION
+#endif
+
 // Soft Serial Transaction Descriptor
 typedef struct _SSTD_t  {
     uint8_t *status;
@@ -60,3 +62,6 @@ int  soft_serial_transaction(int sstd_index);
 #ifdef SERIAL_USE_MULTI_TRANSACTION
 int  soft_serial_get_and_clean_status(int sstd_index);
 #endif
+
+// parity errors in packets received since the last call, on either side
+int  soft_serial_get_and_clean_parity_errors(void);
@@ -0,0 +1,103 @@
+#include "split_state.h"
+#include "transport.h"
+#include "quantum.h"
+
+#ifdef SPLIT_LAYER_STATE_ENABLE
+typedef struct _split_layers_t {
+  uint32_t layers;
+  uint32_t default_layers;
+} split_layers_t;
+
+static split_layers_t split_layers;
+static int8_t split_layers_channel = -1;
+
+static void split_layers_received(void) {
+#ifndef NO_ACTION_LAYER
+  layer_state = split_layers.layers;
+#endif
+  default_layer_state = split_layers.default_layers;
+}
+
+static const transport_channel_t split_layers_config = {
+  &split_layers, sizeof(split_layers), TRANSPORT_TO_SLAVE, 0, split_layers_received
+};
+#endif
+
+#ifdef SPLIT_MODS_ENABLE
+static uint8_t split_mods;
+static int8_t split_mods_channel = -1;
+
+static void split_mods_received(void) {
+  set_mods(split_mods);
+}
+
+static const transport_channel_t split_mods_config = {
+  &split_mods, sizeof(split_mods), TRANSPORT_TO_SLAVE, 0, split_mods_received
+};
+#endif
+
+#ifdef SPLIT_LED_STATE_ENABLE
+static uint8_t split_leds;
+static int8_t split_leds_channel = -1;
+
+static void split_leds_received(void) {
+  led_set(split_leds);
+}
+
+static const transport_channel_t split_leds_config = {
+  &split_leds, sizeof(split_leds), TRANSPORT_TO_SLAVE, 0, split_leds_received
+};
+
+uint8_t split_state_host_leds(void) {
+  return split_leds;
+}
+#endif
+
+void split_state_init(void) {
+  // a slave that just started knows nothing
+#ifdef SPLIT_LAYER_STATE_ENABLE
+  split_layers = (split_layers_t){};
+#endif
+#ifdef SPLIT_MODS_ENABLE
+  split_mods = 0;
+#endif
+#ifdef SPLIT_LED_STATE_ENABLE
+  split_leds = 0;
+#endif
+
+#ifdef SPLIT_LAYER_STATE_ENABLE
+  split_layers_channel = transport_register_channel(&split_layers_config);
+#endif
+#ifdef SPLIT_MODS_ENABLE
+  split_mods_channel = transport_register_channel(&split_mods_config);
+#endif
+#ifdef SPLIT_LED_STATE_ENABLE
+  split_leds_channel = transport_register_channel(&split_leds_config);
+#endif
+}
+
+void split_state_update(void) {
+#ifdef SPLIT_LAYER_STATE_ENABLE
+  if (split_layers.layers != layer_state || split_layers.default_layers != default_layer_state) {
+    split_layers.layers = layer_state;
+    split_layers.default_layers = default_layer_state;
+    transport_channel_changed(split_layers_channel);
+  }
+#endif
+
+#ifdef SPLIT_MODS_ENABLE
+  uint8_t mods = get_mods();
+  if (split_mods != mods) {
+    split_mods = mods;
+    transport_channel_changed(split_mods_channel);
+  }
+#endif
+
+#ifdef SPLIT_LED_STATE_ENABLE
+  uint8_t leds = host_keyboard_leds();
+  if (split_leds != leds) {
+    split_leds = leds;
+    transport_channel_changed(split_leds_channel);
+  }
+#endif
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+/* Mirrors the master's keyboard state to the slave, so that slave side
+ * OLEDs and lighting can follow layers, modifiers and host LEDs.
+ *
+ * Each part is a transport channel of its own and only goes out when it
+ * changed:
+ *   SPLIT_LAYER_STATE_ENABLE  layer_state and default_layer_state
+ *   SPLIT_MODS_ENABLE         the real modifiers, as set_mods() on the slave
+ *   SPLIT_LED_STATE_ENABLE    host LEDs, passed to led_set() on the slave
+ */
+
+// registers the channels, on both halves after the transport
+void split_state_init(void);
+// the master sends whatever changed since the last scan
+void split_state_update(void);
+
+#ifdef SPLIT_LED_STATE_ENABLE
+// the host LEDs as of the last scan, on either half
+uint8_t split_state_host_leds(void);
+#endif
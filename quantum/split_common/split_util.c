@@ -5,6 +5,7 @@
 #include "timer.h"
 #include "split_flags.h"
 #include "transport.h"
+#include "split_state.h"
 #include "quantum.h"
 
 #ifdef EE_HANDS
@@ -60,6 +61,7 @@ static void keyboard_master_setup(void) {
   #endif
 #endif
   transport_master_init();
+  split_state_init();
 
   // For master the Backlight info needs to be sent on startup
   // Otherwise the salve won't start with the proper info until an update
@@ -69,6 +71,7 @@ static void keyboard_master_setup(void) {
 static void keyboard_slave_setup(void)
 {
   transport_slave_init();
+  split_state_init();
 }
 
 // this code runs before the usb and keyboard is initialized
@@ -1,10 +1,632 @@
+#include <string.h>
 
 #include "config.h"
 #include "matrix.h"
 #include "quantum.h"
+#include "transport.h"
 
 #define ROWS_PER_HAND (MATRIX_ROWS/2)
 
+// The other half's rows go over the wire as one bit stream of
+// ROWS_PER_HAND * MATRIX_COLS bits, least significant column first.
+#define PACKED_MATRIX_SIZE ((ROWS_PER_HAND * MATRIX_COLS + 7) / 8)
+
+static void transport_pack_matrix(uint8_t *packed, const matrix_row_t matrix[]) {
+  uint16_t bits = 0;
+  uint8_t count = 0;
+
+  for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+    matrix_row_t value = matrix[row];
+    for (uint8_t left = MATRIX_COLS; left > 0;) {
+      uint8_t take = left < 8 ? left : 8;
+      bits |= (uint16_t)((uint8_t)value & ((1 << take) - 1)) << count;
+      count += take;
+      left -= take;
+      value >>= take;
+      if (count >= 8) {
+        *packed++ = (uint8_t)bits;
+        bits >>= 8;
+        count -= 8;
+      }
+    }
+  }
+  if (count) {
+    *packed = (uint8_t)bits;
+  }
+}
+
+static void transport_unpack_matrix(matrix_row_t matrix[], const uint8_t *packed) {
+  uint16_t bits = 0;
+  uint8_t count = 0;
+
+  for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+    matrix_row_t value = 0;
+    uint8_t shift = 0;
+    for (uint8_t left = MATRIX_COLS; left > 0;) {
+      uint8_t take = left < 8 ? left : 8;
+      if (count < take) {
+        bits |= (uint16_t)*packed++ << count;
+        count += 8;
+      }
+      value |= (matrix_row_t)(bits & ((1 << take) - 1)) << shift;
+      bits >>= take;
+      count -= take;
+      left -= take;
+      shift += take;
+    }
+    matrix[row] = value;
+  }
+}
+
+// The slave numbers every row change and keeps the latest ones, newest
+// first, right behind its sequence number. The master polls just that
+// number and only fetches rows when it has moved, falling back to the whole
+// packed matrix when it missed more changes than the slave keeps.
+#ifndef SPLIT_MATRIX_DELTAS
+#  define SPLIT_MATRIX_DELTAS 4
+#endif
+
+#define ROW_BYTES ((MATRIX_COLS + 7) / 8)
+#define MATRIX_BUFFER_SIZE (PACKED_MATRIX_SIZE + 1 + SPLIT_MATRIX_DELTAS * (1 + ROW_BYTES))
+
+// passed to transport_fetch() for the whole matrix instead of deltas
+#define FETCH_MATRIX 0xFF
+
+// A delta for this row tells the master that channels to it have changed
+#define DELTA_CHANNELS 0xFF
+
+typedef struct _transport_delta_t {
+  uint8_t row;
+  uint8_t value[ROW_BYTES];
+} transport_delta_t;
+
+typedef struct _transport_matrix_buffer_t {
+  uint8_t packed_matrix[PACKED_MATRIX_SIZE];
+  uint8_t seq;
+  transport_delta_t deltas[SPLIT_MATRIX_DELTAS];
+} transport_matrix_buffer_t;
+
+#if defined(__AVR__)
+#  define TRANSPORT_LOCK()   cli()
+#  define TRANSPORT_UNLOCK() sei()
+#else
+#  define TRANSPORT_LOCK()
+#  define TRANSPORT_UNLOCK()
+#endif
+
+// Fetches the sequence number followed by that many deltas, or the packed
+// matrix and the sequence number for FETCH_MATRIX. Provided by the transport.
+static bool transport_fetch(uint8_t deltas);
+
+static matrix_row_t published_matrix[ROWS_PER_HAND];
+
+// Called with the transport locked
+static void transport_push_delta(transport_matrix_buffer_t *buffer, uint8_t row, matrix_row_t value) {
+  for (uint8_t i = SPLIT_MATRIX_DELTAS - 1; i > 0; i--) {
+    buffer->deltas[i] = buffer->deltas[i - 1];
+  }
+  buffer->deltas[0].row = row;
+  for (uint8_t i = 0; i < ROW_BYTES; i++) {
+    buffer->deltas[0].value[i] = (uint8_t)value;
+    value >>= 8;
+  }
+  buffer->seq++;
+}
+
+static void transport_publish_matrix(transport_matrix_buffer_t *buffer, const matrix_row_t matrix[]) {
+  bool changed = false;
+
+  TRANSPORT_LOCK();
+  for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+    matrix_row_t value = matrix[row];
+    if (value == published_matrix[row]) {
+      continue;
+    }
+    published_matrix[row] = value;
+    transport_push_delta(buffer, row, value);
+    changed = true;
+  }
+  if (changed) {
+    transport_pack_matrix(buffer->packed_matrix, matrix);
+  }
+  TRANSPORT_UNLOCK();
+}
+
+// Bytes a scan may spend on the link past the first matrix fetch
+#ifndef SPLIT_CHANNEL_BUDGET
+#  define SPLIT_CHANNEL_BUDGET 32
+#endif
+
+// A matrix transaction that fails while the link was up is most likely a
+// glitch on the wire, so the master may try it again within the same scan.
+// Retries come out of the scan's budget, ahead of the channels.
+#ifndef SPLIT_MATRIX_RETRIES
+#  define SPLIT_MATRIX_RETRIES 0
+#endif
+
+#ifdef SPLIT_LINK_STATS
+static transport_link_stats_t link_stats;
+#  define LINK_STAT(field) (link_stats.field++)
+#else
+#  define LINK_STAT(field)
+#endif
+
+static uint8_t fetched_seq;
+static bool fetched_matrix = false;
+// Set when the slave may have changed a channel to the master
+static bool fetch_channels = false;
+
+static uint16_t scan_spent;
+static uint8_t scan_retries;
+
+static bool transport_fetch_retry(uint8_t deltas) {
+  uint8_t cost = deltas == FETCH_MATRIX ? PACKED_MATRIX_SIZE + 1 : 1 + deltas * sizeof(transport_delta_t);
+  bool retried = false;
+
+  for (;;) {
+    LINK_STAT(transactions);
+    if (transport_fetch(deltas)) {
+      if (retried) {
+        LINK_STAT(recovered);
+      }
+      return true;
+    }
+    LINK_STAT(failures);
+
+    if (scan_retries == 0 || scan_spent + cost > SPLIT_CHANNEL_BUDGET) {
+      return false;
+    }
+    scan_retries--;
+    scan_spent += cost;
+    retried = true;
+    LINK_STAT(retries);
+  }
+}
+
+static bool transport_update_matrix(transport_matrix_buffer_t *buffer, matrix_row_t matrix[]) {
+  if (!transport_fetch_retry(0)) {
+    fetched_matrix = false;
+    return false;
+  }
+
+  uint8_t seq = buffer->seq;
+  if (fetched_matrix && seq == fetched_seq) {
+    return true;
+  }
+
+  uint8_t count = seq - fetched_seq;
+  if (fetched_matrix && count <= SPLIT_MATRIX_DELTAS) {
+    if (!transport_fetch_retry(count)) {
+      fetched_matrix = false;
+      return false;
+    }
+
+    // the slave may have moved on in between, then only the matrix will do
+    bool valid = buffer->seq == seq;
+    for (uint8_t i = 0; i < count; i++) {
+      uint8_t row = buffer->deltas[i].row;
+      valid = valid && (row < ROWS_PER_HAND || row == DELTA_CHANNELS);
+    }
+    if (valid) {
+      for (uint8_t i = count; i > 0; i--) {
+        const transport_delta_t *delta = &buffer->deltas[i - 1];
+        if (delta->row == DELTA_CHANNELS) {
+          fetch_channels = true;
+          continue;
+        }
+        matrix_row_t value = 0;
+        for (uint8_t j = ROW_BYTES; j > 0; j--) {
+          value = (value << 8) | delta->value[j - 1];
+        }
+        matrix[delta->row] = value;
+      }
+      fetched_seq = seq;
+      return true;
+    }
+  }
+
+  if (!transport_fetch_retry(FETCH_MATRIX)) {
+    fetched_matrix = false;
+    return false;
+  }
+  transport_unpack_matrix(matrix, buffer->packed_matrix);
+  fetched_seq = buffer->seq;
+  fetched_matrix = true;
+  // whatever the skipped deltas said
+  fetch_channels = true;
+  return true;
+}
+
+#ifdef SPLIT_LINK_STATS
+#  if defined(__AVR__)
+#    include <avr/io.h>
+#    ifdef __AVR_ATmega32A__
+#      define TIMER_FLAGS TIFR
+#      define TIMER_TICK  OCF0
+#    else
+#      define TIMER_FLAGS TIFR0
+#      define TIMER_TICK  OCF0A
+#    endif
+
+// Soft serial keeps interrupts off for a whole transaction, so the
+// millisecond count may lag behind Timer0. Its pending compare flag makes
+// up for one tick, which is enough to tell times past a millisecond apart.
+static uint32_t transport_micros(void) {
+  uint8_t sreg = SREG;
+  cli();
+  uint32_t ms = timer_count;
+  uint8_t raw = TIMER_RAW;
+  if (TIMER_FLAGS & _BV(TIMER_TICK)) {
+    ms++;
+    raw = TIMER_RAW;
+  }
+  SREG = sreg;
+  return ms * 1000 + (uint32_t)raw * 1000000 / TIMER_RAW_FREQ;
+}
+#  else
+static uint32_t transport_micros(void) {
+  return timer_read32() * 1000;
+}
+#  endif
+
+static void transport_count_latency(uint32_t time) {
+  uint32_t bucket = time / TRANSPORT_LATENCY_STEP;
+  if (bucket > TRANSPORT_LATENCY_BUCKETS) {
+    bucket = TRANSPORT_LATENCY_BUCKETS;
+  }
+  link_stats.latency[bucket]++;
+}
+#endif
+
+static bool transport_fetch_matrix(transport_matrix_buffer_t *buffer, matrix_row_t matrix[]) {
+  scan_spent = 0;
+  scan_retries = fetched_matrix ? SPLIT_MATRIX_RETRIES : 0;
+
+#ifdef SPLIT_LINK_STATS
+  uint32_t start = transport_micros();
+  if (!transport_update_matrix(buffer, matrix)) {
+    return false;
+  }
+  transport_count_latency(transport_micros() - start);
+  return true;
+#else
+  return transport_update_matrix(buffer, matrix);
+#endif
+}
+
+#ifdef SPLIT_LINK_STATS
+void transport_get_link_stats(transport_link_stats_t *stats) {
+  *stats = link_stats;
+}
+
+void transport_reset_link_stats(void) {
+  memset(&link_stats, 0, sizeof(link_stats));
+}
+
+uint16_t transport_link_latency(const transport_link_stats_t *stats, uint8_t percent) {
+  // the counters run for days, their sum and products don't fit 32 bits
+  uint64_t total = 0;
+  for (uint8_t i = 0; i <= TRANSPORT_LATENCY_BUCKETS; i++) {
+    total += stats->latency[i];
+  }
+  if (total == 0) {
+    return 0;
+  }
+
+  // the bucket holding the sample that many percent of all are not above
+  uint64_t rank = (total * percent + 99) / 100;
+  uint64_t seen = 0;
+  for (uint8_t i = 0; i < TRANSPORT_LATENCY_BUCKETS; i++) {
+    seen += stats->latency[i];
+    if (seen >= rank) {
+      return (i + 1) * TRANSPORT_LATENCY_STEP;
+    }
+  }
+  return UINT16_MAX;
+}
+
+void transport_print_link_stats(void) {
+  print("\n\t- Split link -\n");
+  print_val_hex32(link_stats.transactions);
+  print_val_hex32(link_stats.failures);
+  print_val_hex32(link_stats.retries);
+  print_val_hex32(link_stats.recovered);
+  print_val_hex32(link_stats.parity_errors);
+  xprintf("latency p50/p90/p99: %u/%u/%u us\n",
+    transport_link_latency(&link_stats, 50),
+    transport_link_latency(&link_stats, 90),
+    transport_link_latency(&link_stats, 99));
+}
+#endif
+
+// Channels are copied through a staging area in a pool that the transport
+// can reach from its interrupt. Each channel's area holds what the master
+// reads back (rx) followed by what it writes (tx). Channels larger than a
+// slice carry an ack from the slave in rx and one slice of the buffer in tx,
+// so only the master can send those.
+#ifndef SPLIT_CHANNELS
+#  define SPLIT_CHANNELS 6
+#endif
+
+#ifndef SPLIT_CHANNEL_SLICE
+#  define SPLIT_CHANNEL_SLICE 16
+#endif
+
+// Marks a slice of a pass over the buffer, and tells the master which slice
+// of which pass the slave wants next
+typedef struct __attribute__((packed)) _transport_slice_t {
+  uint8_t pass;
+  uint16_t offset;
+} transport_slice_t;
+
+typedef struct _transport_channel_state_t {
+  const transport_channel_t *channel;
+  uint8_t offset;
+  uint8_t rx_size;
+  uint8_t tx_size;
+  // sending half: the other half has not got the last change yet
+  bool pending;
+  // sliced channels: the master starts a new pass before the next slice
+  bool restart;
+  uint8_t pass;
+  // sliced channels: on the master the offset of the last slice sent, on
+  // the slave the bytes of the current pass so far
+  uint16_t position;
+} transport_channel_state_t;
+
+static transport_channel_state_t channels[SPLIT_CHANNELS];
+// channel ids by priority
+static uint8_t channel_order[SPLIT_CHANNELS];
+static uint8_t channel_count = 0;
+static uint8_t channel_pool_used = 0;
+
+// The staging areas, set up by the transport's init
+static uint8_t *channel_pool;
+static uint8_t channel_pool_size;
+
+// Provided by the transport: the master reads the channel's rx area from
+// the slave, then writes its tx area.
+static bool transport_exchange(uint8_t id);
+// Provided by the transport: whether the master wrote the channel's tx area
+// since the slave last asked.
+static bool transport_arrived(uint8_t id);
+// Provided by the transport: lets the link know about a new channel.
+static void transport_channel_added(uint8_t id);
+
+static inline bool transport_channel_sliced(const transport_channel_state_t *ch) {
+  return ch->channel->size > SPLIT_CHANNEL_SLICE;
+}
+
+static void transport_reset_channels(uint8_t *pool, uint8_t size) {
+  channel_count = 0;
+  channel_pool_used = 0;
+  channel_pool = pool;
+  channel_pool_size = size;
+  fetch_channels = false;
+}
+
+int8_t transport_register_channel(const transport_channel_t *channel) {
+  if (channel_count >= SPLIT_CHANNELS) {
+    return -1;
+  }
+
+  uint8_t rx_size = 0;
+  uint8_t tx_size = 0;
+  if (channel->size > SPLIT_CHANNEL_SLICE) {
+    if (channel->direction != TRANSPORT_TO_SLAVE) {
+      return -1;
+    }
+    rx_size = sizeof(transport_slice_t);
+    tx_size = sizeof(transport_slice_t) + SPLIT_CHANNEL_SLICE;
+  } else if (channel->direction == TRANSPORT_TO_SLAVE) {
+    tx_size = channel->size;
+  } else {
+    rx_size = channel->size;
+  }
+  if (channel_pool_used + rx_size + tx_size > channel_pool_size) {
+    return -1;
+  }
+
+  uint8_t id = channel_count++;
+  transport_channel_state_t *ch = &channels[id];
+  *ch = (transport_channel_state_t){
+    .channel = channel,
+    .offset = channel_pool_used,
+    .rx_size = rx_size,
+    .tx_size = tx_size,
+  };
+  channel_pool_used += rx_size + tx_size;
+  memset(channel_pool + ch->offset, 0, rx_size + tx_size);
+
+  // after the channels it does not go before
+  uint8_t i = id;
+  while (i > 0 && channels[channel_order[i - 1]].channel->priority > channel->priority) {
+    channel_order[i] = channel_order[i - 1];
+    i--;
+  }
+  channel_order[i] = id;
+
+  transport_channel_added(id);
+  return id;
+}
+
+void transport_channel_changed(int8_t id) {
+  if (id < 0 || id >= channel_count) {
+    return;
+  }
+  channels[id].pending = true;
+  channels[id].restart = true;
+}
+
+bool transport_channel_pending(int8_t id) {
+  return id >= 0 && id < channel_count && channels[id].pending;
+}
+
+// After the link went down the slave may have restarted, so everything it
+// should have goes again
+static void transport_channels_lost(void) {
+  for (uint8_t id = 0; id < channel_count; id++) {
+    if (channels[id].channel->direction == TRANSPORT_TO_SLAVE) {
+      transport_channel_changed(id);
+    }
+  }
+}
+
+// Puts the next slice in the tx area, or returns false once the slave has
+// the whole pass. The ack was read before the slave could take the slice
+// sent last, so the master moves on unless the ack says the slave fell
+// behind that, and repeats the last slice until the slave confirms it.
+static bool transport_next_slice(transport_channel_state_t *ch) {
+  const transport_channel_t *channel = ch->channel;
+  uint8_t *staging = channel_pool + ch->offset;
+  transport_slice_t ack;
+  memcpy(&ack, staging, sizeof(ack));
+
+  uint16_t next = 0;
+  if (ch->restart) {
+    ch->restart = false;
+    ch->pass++;
+  } else {
+    uint16_t wanted = ack.pass == ch->pass ? ack.offset : 0;
+    if (wanted >= channel->size) {
+      return false;
+    }
+    next = wanted;
+    if (wanted >= ch->position) {
+      next = ch->position + SPLIT_CHANNEL_SLICE;
+      if (next >= channel->size) {
+        next = ch->position;
+      }
+    }
+  }
+  ch->position = next;
+
+  uint16_t length = channel->size - next;
+  if (length > SPLIT_CHANNEL_SLICE) {
+    length = SPLIT_CHANNEL_SLICE;
+  }
+  transport_slice_t slice = { ch->pass, next };
+  memcpy(staging + ch->rx_size, &slice, sizeof(slice));
+  memcpy(staging + ch->rx_size + sizeof(slice), (const uint8_t *)channel->buffer + next, length);
+  return true;
+}
+
+static void transport_master_channels(void) {
+  if (fetch_channels) {
+    fetch_channels = false;
+    for (uint8_t id = 0; id < channel_count; id++) {
+      if (channels[id].channel->direction == TRANSPORT_TO_MASTER) {
+        channels[id].pending = true;
+      }
+    }
+  }
+
+  for (uint8_t i = 0; i < channel_count; i++) {
+    uint8_t id = channel_order[i];
+    transport_channel_state_t *ch = &channels[id];
+    const transport_channel_t *channel = ch->channel;
+    if (!ch->pending) {
+      continue;
+    }
+
+    // the first channel always goes, however big, unless retries took
+    // the budget
+    uint8_t cost = ch->rx_size + ch->tx_size;
+    if (scan_spent > 0 && scan_spent + cost > SPLIT_CHANNEL_BUDGET) {
+      break;
+    }
+
+    uint8_t *staging = channel_pool + ch->offset;
+    if (transport_channel_sliced(ch)) {
+      if (!transport_next_slice(ch)) {
+        ch->pending = false;
+        continue;
+      }
+    } else if (channel->direction == TRANSPORT_TO_SLAVE) {
+      memcpy(staging, channel->buffer, channel->size);
+    }
+
+    LINK_STAT(transactions);
+    if (!transport_exchange(id)) {
+      LINK_STAT(failures);
+      // try again on the next scan
+      return;
+    }
+    scan_spent += cost;
+
+    if (transport_channel_sliced(ch)) {
+      // done once the slave says so
+      continue;
+    }
+    ch->pending = false;
+    if (channel->direction == TRANSPORT_TO_MASTER) {
+      memcpy(channel->buffer, staging, channel->size);
+      if (channel->received) {
+        channel->received();
+      }
+    }
+  }
+}
+
+static void transport_slave_channels(transport_matrix_buffer_t *buffer) {
+  bool staged = false;
+
+  TRANSPORT_LOCK();
+  for (uint8_t id = 0; id < channel_count; id++) {
+    transport_channel_state_t *ch = &channels[id];
+    if (ch->channel->direction == TRANSPORT_TO_MASTER && ch->pending) {
+      memcpy(channel_pool + ch->offset, ch->channel->buffer, ch->channel->size);
+      ch->pending = false;
+      staged = true;
+    }
+  }
+  if (staged) {
+    transport_push_delta(buffer, DELTA_CHANNELS, 0);
+  }
+  TRANSPORT_UNLOCK();
+
+  for (uint8_t id = 0; id < channel_count; id++) {
+    transport_channel_state_t *ch = &channels[id];
+    const transport_channel_t *channel = ch->channel;
+    if (channel->direction != TRANSPORT_TO_SLAVE || !transport_arrived(id)) {
+      continue;
+    }
+
+    uint8_t *staging = channel_pool + ch->offset;
+    bool complete = true;
+    TRANSPORT_LOCK();
+    if (transport_channel_sliced(ch)) {
+      transport_slice_t slice;
+      memcpy(&slice, staging + ch->rx_size, sizeof(slice));
+      if (slice.pass != ch->pass && slice.offset == 0) {
+        ch->pass = slice.pass;
+        ch->position = 0;
+      }
+
+      complete = false;
+      if (slice.pass == ch->pass && slice.offset == ch->position && ch->position < channel->size) {
+        uint16_t length = channel->size - slice.offset;
+        if (length > SPLIT_CHANNEL_SLICE) {
+          length = SPLIT_CHANNEL_SLICE;
+        }
+        memcpy((uint8_t *)channel->buffer + slice.offset, staging + ch->rx_size + sizeof(slice), length);
+        ch->position += length;
+        complete = ch->position == channel->size;
+      }
+
+      transport_slice_t ack = { ch->pass, ch->position };
+      memcpy(staging, &ack, sizeof(ack));
+    } else {
+      memcpy(channel->buffer, staging, channel->size);
+    }
+    TRANSPORT_UNLOCK();
+
+    if (complete && channel->received) {
+      channel->received();
+    }
+  }
+}
+
 #ifdef RGBLIGHT_ENABLE
 #   include "rgblight.h"
 #endif
@@ -17,15 +639,95 @@
 #if defined(USE_I2C) || defined(EH)
 
 #include "i2c.h"
+#include "split_flags.h"
 
 #ifndef SLAVE_I2C_ADDRESS
 #  define SLAVE_I2C_ADDRESS           0x32
 #endif
 
-#if (MATRIX_COLS > 8)
-#  error "Currently only supports 8 COLS"
+#ifdef RGBLIGHT_ENABLE
+_Static_assert(sizeof(rgblight_syncinfo_t) == I2C_RGB_SIZE, "I2C_RGB_SIZE does not match rgblight_syncinfo_t");
+#endif
+
+#if (I2C_KEYMAP_START + MATRIX_BUFFER_SIZE > SLAVE_BUFFER_SIZE)
+#  error "The matrix of one half does not fit the I2C slave buffer, try a smaller SPLIT_MATRIX_DELTAS"
 #endif
 
+// Channels live in the slave buffer after the matrix
+#define I2C_CHANNEL_START (I2C_KEYMAP_START + MATRIX_BUFFER_SIZE)
+#define CHANNEL_POOL_SIZE (SLAVE_BUFFER_SIZE - I2C_CHANNEL_START)
+
+// The master's copy of the slave's matrix buffer at I2C_KEYMAP_START
+static transport_matrix_buffer_t i2c_matrix_buffer;
+// and of its channels
+static uint8_t i2c_channel_pool[CHANNEL_POOL_SIZE];
+
+static bool transport_fetch(uint8_t deltas) {
+  uint8_t offset = offsetof(transport_matrix_buffer_t, seq);
+  uint8_t length = 1 + deltas * sizeof(transport_delta_t);
+  if (deltas == FETCH_MATRIX) {
+    offset = 0;
+    length = PACKED_MATRIX_SIZE + 1;
+  }
+
+  if (i2c_master_start(SLAVE_I2C_ADDRESS + I2C_WRITE)) { return false; }
+  if (i2c_master_write(I2C_KEYMAP_START + offset)) { return false; }
+  if (i2c_master_start(SLAVE_I2C_ADDRESS + I2C_READ)) { return false; }
+
+  uint8_t *data = (uint8_t *)&i2c_matrix_buffer + offset;
+  for (uint8_t i = 0; i < length - 1; ++i) {
+    data[i] = i2c_master_read(I2C_ACK);
+  }
+  data[length - 1] = i2c_master_read(I2C_NACK);
+  i2c_master_stop();
+  return true;
+}
+
+static bool transport_exchange(uint8_t id) {
+  const transport_channel_state_t *ch = &channels[id];
+  uint8_t *staging = channel_pool + ch->offset;
+  uint8_t reg = I2C_CHANNEL_START + ch->offset;
+
+  if (ch->rx_size) {
+    if (i2c_master_start(SLAVE_I2C_ADDRESS + I2C_WRITE)) { goto i2c_error; }
+    if (i2c_master_write(reg)) { goto i2c_error; }
+    if (i2c_master_start(SLAVE_I2C_ADDRESS + I2C_READ)) { goto i2c_error; }
+    for (uint8_t i = 0; i < ch->rx_size - 1; ++i) {
+      staging[i] = i2c_master_read(I2C_ACK);
+    }
+    staging[ch->rx_size - 1] = i2c_master_read(I2C_NACK);
+    i2c_master_stop();
+  }
+
+  if (ch->tx_size) {
+    if (i2c_master_start(SLAVE_I2C_ADDRESS + I2C_WRITE)) { goto i2c_error; }
+    if (i2c_master_write(reg + ch->rx_size)) { goto i2c_error; }
+    if (i2c_master_write_data(staging + ch->rx_size, ch->tx_size)) { goto i2c_error; }
+    i2c_master_stop();
+  }
+  return true;
+
+i2c_error:
+  i2c_reset_state();
+  return false;
+}
+
+static bool transport_arrived(uint8_t id) {
+  const transport_channel_state_t *ch = &channels[id];
+  // the master writes the whole area, so its last byte will do
+  uint8_t last = I2C_CHANNEL_START + ch->offset + ch->rx_size + ch->tx_size - 1;
+  uint8_t mask = 1 << (last & 7);
+
+  TRANSPORT_LOCK();
+  bool arrived = i2c_slave_written[last >> 3] & mask;
+  i2c_slave_written[last >> 3] &= ~mask;
+  TRANSPORT_UNLOCK();
+  return arrived;
+}
+
+static void transport_channel_added(uint8_t id) {
+}
+
 // Get rows from other half over i2c
 bool transport_master(matrix_row_t matrix[]) {
   int err = 0;
@@ -47,32 +749,14 @@ bool transport_master(matrix_row_t matrix[]) {
   }
 #endif
 
-  err = i2c_master_start(SLAVE_I2C_ADDRESS + I2C_WRITE);
+  err = !transport_fetch_matrix(&i2c_matrix_buffer, matrix);
   if (err) { goto i2c_error; }
 
-  // start of matrix stored at I2C_KEYMAP_START
-  err = i2c_master_write(I2C_KEYMAP_START);
-  if (err) { goto i2c_error; }
-
-  // Start read
-  err = i2c_master_start(SLAVE_I2C_ADDRESS + I2C_READ);
-  if (err) { goto i2c_error; }
-
-  if (!err) {
-    int i;
-    for (i = 0; i < ROWS_PER_HAND-1; ++i) {
-      matrix[i] = i2c_master_read(I2C_ACK);
-    }
-    matrix[i] = i2c_master_read(I2C_NACK);
-    i2c_master_stop();
-  } else {
-i2c_error: // the cable is disconnceted, or something else went wrong
-    i2c_reset_state();
-    return false;
-  }
-
 #ifdef RGBLIGHT_ENABLE
-  if (RGB_DIRTY) {
+  if (RGB_DIRTY || rgblight_sync_pending()) {
+    // stays dirty until the slave has it
+    RGB_DIRTY = true;
+
     err = i2c_master_start(SLAVE_I2C_ADDRESS + I2C_WRITE);
     if (err) { goto i2c_error; }
 
@@ -80,10 +764,11 @@ i2c_error: // the cable is disconnceted, or something else went wrong
     err = i2c_master_write(I2C_RGB_START);
     if (err) { goto i2c_error; }
 
-    uint32_t dword = eeconfig_read_rgblight();
+    rgblight_syncinfo_t syncinfo;
+    rgblight_get_syncinfo(&syncinfo);
 
     // Write RGB
-    err = i2c_master_write_data(&dword, 4);
+    err = i2c_master_write_data(&syncinfo, sizeof(syncinfo));
     if (err) { goto i2c_error; }
 
     RGB_DIRTY = false;
@@ -91,15 +776,21 @@ i2c_error: // the cable is disconnceted, or something else went wrong
   }
 #endif
 
+  transport_master_channels();
   return true;
+
+i2c_error: // the cable is disconnceted, or something else went wrong
+  i2c_reset_state();
+  transport_channels_lost();
+  return false;
 }
 
 void transport_slave(matrix_row_t matrix[]) {
+  transport_matrix_buffer_t *buffer = (transport_matrix_buffer_t *)&i2c_slave_buffer[I2C_KEYMAP_START];
+
+  transport_publish_matrix(buffer, matrix);
+  transport_slave_channels(buffer);
 
-  for (int i = 0; i < ROWS_PER_HAND; ++i)
-  {
-    i2c_slave_buffer[I2C_KEYMAP_START + i] = matrix[i];
-  }
   // Read Backlight Info
   #ifdef BACKLIGHT_ENABLE
   if (BACKLIT_DIRTY)
@@ -111,32 +802,31 @@ void transport_slave(matrix_row_t matrix[]) {
   #ifdef RGBLIGHT_ENABLE
   if (RGB_DIRTY)
   {
-    // Disable interupts (RGB data is big)
-    cli();
-    // Create new DWORD for RGB data
-    uint32_t dword;
-
-    // Fill the new DWORD with the data that was sent over
-    uint8_t * dword_dat = (uint8_t *)(&dword);
-    for (int i = 0; i < 4; i++)
+    rgblight_syncinfo_t syncinfo;
+
+    // Disable interupts while copying (RGB data is big)
+    TRANSPORT_LOCK();
+    uint8_t * syncinfo_dat = (uint8_t *)(&syncinfo);
+    for (uint8_t i = 0; i < sizeof(syncinfo); i++)
     {
-      dword_dat[i] = i2c_slave_buffer[I2C_RGB_START + i];
+      syncinfo_dat[i] = i2c_slave_buffer[I2C_RGB_START + i];
     }
-
-    // Update the RGB now with the new data and set RGB_DIRTY to false
-    rgblight_update_dword(dword);
     RGB_DIRTY = false;
-    // Re-enable interupts now that RGB is set
-    sei();
+    TRANSPORT_UNLOCK();
+
+    // Take over the master's lighting and animation phase, without EEPROM
+    rgblight_update_sync(&syncinfo);
   }
   #endif
 }
 
 void transport_master_init(void) {
+  transport_reset_channels(i2c_channel_pool, CHANNEL_POOL_SIZE);
   i2c_master_init();
 }
 
 void transport_slave_init(void) {
+  transport_reset_channels((uint8_t *)&i2c_slave_buffer[I2C_CHANNEL_START], CHANNEL_POOL_SIZE);
   i2c_slave_init(SLAVE_I2C_ADDRESS);
 }
 
@@ -144,81 +834,171 @@ void transport_slave_init(void) {
 
 #include "serial.h"
 
-typedef struct _Serial_s2m_buffer_t {
-  // TODO: if MATRIX_COLS > 8 change to uint8_t packed_matrix[] for pack/unpack
-  matrix_row_t smatrix[ROWS_PER_HAND];
-} Serial_s2m_buffer_t;
+#ifndef SPLIT_CHANNEL_POOL_SIZE
+#  define SPLIT_CHANNEL_POOL_SIZE 64
+#endif
+#define CHANNEL_POOL_SIZE SPLIT_CHANNEL_POOL_SIZE
 
-typedef struct _Serial_m2s_buffer_t {
-#ifdef BACKLIGHT_ENABLE
-    uint8_t backlight_level;
+#if (CHANNEL_POOL_SIZE > 255)
+#  error "SPLIT_CHANNEL_POOL_SIZE must fit in a byte"
 #endif
-#if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
-    rgblight_config_t rgblight_config; //not yet use
-    //
-    // When MCUs on both sides drive their respective RGB LED chains,
-    // it is necessary to synchronize, so it is necessary to communicate RGB information.
-    // In that case, define the RGBLIGHT_SPLIT macro.
-    //
-    // Otherwise, if the master side MCU drives both sides RGB LED chains,
-    // there is no need to communicate.
-#endif
-} Serial_m2s_buffer_t;
-
-volatile Serial_s2m_buffer_t serial_s2m_buffer = {};
-volatile Serial_m2s_buffer_t serial_m2s_buffer = {};
-uint8_t volatile status0 = 0;
-
-SSTD_t transactions[] = {
-  { (uint8_t *)&status0,
-    sizeof(serial_m2s_buffer), (uint8_t *)&serial_m2s_buffer,
-    sizeof(serial_s2m_buffer), (uint8_t *)&serial_s2m_buffer
-  }
-};
 
-void transport_master_init(void)
-{ soft_serial_initiator_init(transactions, TID_LIMIT(transactions)); }
+static volatile transport_matrix_buffer_t serial_matrix_buffer = {};
+static uint8_t volatile status0 = 0;
+static uint8_t volatile channel_status[SPLIT_CHANNELS];
+static uint8_t serial_channel_pool[CHANNEL_POOL_SIZE];
 
-void transport_slave_init(void)
-{ soft_serial_target_init(transactions, TID_LIMIT(transactions)); }
+// Transaction n reads the sequence number and n deltas, TID_MATRIX reads
+// the whole matrix and TID_CHANNEL(id) exchanges a channel's staging area.
+#define TID_DELTAS(n)   (n)
+#define TID_MATRIX      (SPLIT_MATRIX_DELTAS + 1)
+#define TID_CHANNEL(id) (TID_MATRIX + 1 + (id))
 
-bool transport_master(matrix_row_t matrix[]) {
+#if (TID_CHANNEL(SPLIT_CHANNELS - 1) > 15)
+#  error "SPLIT_MATRIX_DELTAS and SPLIT_CHANNELS do not fit the soft serial transaction id"
+#endif
 
-  if (soft_serial_transaction()) {
-    return false;
+static SSTD_t transactions[TID_CHANNEL(SPLIT_CHANNELS)];
+
+static void transport_init_transactions(void) {
+  for (uint8_t n = 0; n <= SPLIT_MATRIX_DELTAS; n++) {
+    transactions[TID_DELTAS(n)] = (SSTD_t){ (uint8_t *)&status0,
+      0, NULL,
+      1 + n * sizeof(transport_delta_t), (uint8_t *)&serial_matrix_buffer.seq
+    };
   }
 
-  // TODO:  if MATRIX_COLS > 8 change to unpack()
-  for (int i = 0; i < ROWS_PER_HAND; ++i) {
-    matrix[i] = serial_s2m_buffer.smatrix[i];
+  transactions[TID_MATRIX] = (SSTD_t){ (uint8_t *)&status0,
+    0, NULL,
+    PACKED_MATRIX_SIZE + 1, (uint8_t *)&serial_matrix_buffer.packed_matrix
+  };
+
+  for (uint8_t id = 0; id < SPLIT_CHANNELS; id++) {
+    transactions[TID_CHANNEL(id)] = (SSTD_t){ (uint8_t *)&channel_status[id], 0, NULL, 0, NULL };
   }
+}
 
-  #if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
-    // Code to send RGB over serial goes here (not implemented yet)
-  #endif
+static bool transport_fetch(uint8_t deltas) {
+  return soft_serial_transaction(deltas == FETCH_MATRIX ? TID_MATRIX : TID_DELTAS(deltas)) == TRANSACTION_END;
+}
+
+static bool transport_exchange(uint8_t id) {
+  return soft_serial_transaction(TID_CHANNEL(id)) == TRANSACTION_END;
+}
+
+static bool transport_arrived(uint8_t id) {
+  return soft_serial_get_and_clean_status(TID_CHANNEL(id)) & TRANSACTION_ACCEPTED;
+}
+
+static void transport_channel_added(uint8_t id) {
+  const transport_channel_state_t *ch = &channels[id];
+  uint8_t *staging = channel_pool + ch->offset;
+
+  transactions[TID_CHANNEL(id)] = (SSTD_t){ (uint8_t *)&channel_status[id],
+    ch->tx_size, ch->tx_size ? staging + ch->rx_size : NULL,
+    ch->rx_size, ch->rx_size ? staging : NULL
+  };
+}
+
+// The master's backlight and lighting state go to the slave as channels
+#ifdef BACKLIGHT_ENABLE
+static uint8_t backlight_sync;
+static int8_t backlight_channel;
+
+static void transport_backlight_received(void) {
+  backlight_set(backlight_sync);
+}
+
+static const transport_channel_t backlight_channel_config = {
+  &backlight_sync, sizeof(backlight_sync), TRANSPORT_TO_SLAVE, 0, transport_backlight_received
+};
+#endif
+
+#if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+// When MCUs on both sides drive their respective RGB LED chains,
+// it is necessary to synchronize, so it is necessary to communicate RGB information.
+// In that case, define the RGBLIGHT_SPLIT macro.
+//
+// Otherwise, if the master side MCU drives both sides RGB LED chains,
+// there is no need to communicate.
+static rgblight_syncinfo_t rgblight_sync;
+static int8_t rgblight_channel;
+
+static void transport_rgblight_received(void) {
+  // Take over the master's lighting and animation phase, without EEPROM
+  rgblight_update_sync(&rgblight_sync);
+}
+
+static const transport_channel_t rgblight_channel_config = {
+  &rgblight_sync, sizeof(rgblight_sync), TRANSPORT_TO_SLAVE, 0, transport_rgblight_received
+};
+#endif
+
+static void transport_init_channels(void) {
+  transport_reset_channels(serial_channel_pool, CHANNEL_POOL_SIZE);
+  transport_init_transactions();
 
   #ifdef BACKLIGHT_ENABLE
-    // Write backlight level for slave to read
-    serial_m2s_buffer.backlight_level = backlight_config.enable ? backlight_config.level : 0;
+    backlight_channel = transport_register_channel(&backlight_channel_config);
+    transport_channel_changed(backlight_channel);
+  #endif
+  #if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
+    rgblight_channel = transport_register_channel(&rgblight_channel_config);
+    transport_channel_changed(rgblight_channel);
   #endif
+}
 
-  return true;
+void transport_master_init(void) {
+  transport_init_channels();
+  soft_serial_initiator_init(transactions, TID_LIMIT(transactions));
 }
 
-void transport_slave(matrix_row_t matrix[]) {
+void transport_slave_init(void) {
+  transport_init_channels();
+  soft_serial_target_init(transactions, TID_LIMIT(transactions));
+}
 
-  // TODO: if MATRIX_COLS > 8 change to pack()
-  for (int i = 0; i < ROWS_PER_HAND; ++i)
-  {
-    serial_s2m_buffer.smatrix[i] = matrix[i];
+bool transport_master(matrix_row_t matrix[]) {
+  bool fetched = transport_fetch_matrix((transport_matrix_buffer_t *)&serial_matrix_buffer, matrix);
+
+  #ifdef SPLIT_LINK_STATS
+    link_stats.parity_errors += soft_serial_get_and_clean_parity_errors();
+  #endif
+
+  if (!fetched) {
+    transport_channels_lost();
+    return false;
   }
+
   #ifdef BACKLIGHT_ENABLE
-    backlight_set(serial_m2s_buffer.backlight_level);
+    uint8_t level = backlight_config.enable ? backlight_config.level : 0;
+    if (backlight_sync != level) {
+      backlight_sync = level;
+      transport_channel_changed(backlight_channel);
+    }
   #endif
+
   #if defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
-  // Add serial implementation for RGB here
+    // a resend carries the animation phase as of now
+    if (rgblight_sync_pending() || transport_channel_pending(rgblight_channel)) {
+      rgblight_get_syncinfo(&rgblight_sync);
+      transport_channel_changed(rgblight_channel);
+    }
   #endif
 
+  transport_master_channels();
+  return true;
+}
+
+void transport_slave(matrix_row_t matrix[]) {
+  transport_matrix_buffer_t *buffer = (transport_matrix_buffer_t *)&serial_matrix_buffer;
+
+  transport_publish_matrix(buffer, matrix);
+  transport_slave_channels(buffer);
+
+  #ifdef SPLIT_LINK_STATS
+    link_stats.parity_errors += soft_serial_get_and_clean_parity_errors();
+  #endif
 }
 
 #endif
@@ -8,3 +8,62 @@ void transport_slave_init(void);
 // returns false if valid data not received from slave
 bool transport_master(matrix_row_t matrix[]);
 void transport_slave(matrix_row_t matrix[]);
+
+/* Channels carry feature state between the halves, next to the matrix.
+ *
+ * A channel is a buffer the feature owns on both halves. The sending half
+ * updates it and calls transport_channel_changed(); on one of the next scans
+ * the transport copies it over and calls received() on the other half.
+ * The matrix always goes first, then pending channels by priority, lower
+ * values first, as long as the scan stays within SPLIT_CHANNEL_BUDGET bytes.
+ * Buffers larger than SPLIT_CHANNEL_SLICE go one slice per scan, and only
+ * from the master to the slave.
+ *
+ * Both halves have to register the same channels in the same order, after
+ * the transport has been initialized (matrix_init_user() or later). The
+ * channel description and its buffer must stay around.
+ */
+typedef enum {
+  TRANSPORT_TO_SLAVE,
+  TRANSPORT_TO_MASTER,
+} transport_direction_t;
+
+typedef struct {
+  void *buffer;
+  uint16_t size;
+  transport_direction_t direction;
+  uint8_t priority;
+  // called on the receiving half after the buffer was updated, may be NULL
+  void (*received)(void);
+} transport_channel_t;
+
+// returns the channel id, or -1 if there is no room for it
+int8_t transport_register_channel(const transport_channel_t *channel);
+// the sending half has updated the channel's buffer
+void transport_channel_changed(int8_t id);
+// true until the last change has been handed to the other half
+bool transport_channel_pending(int8_t id);
+
+#ifdef SPLIT_LINK_STATS
+// Matrix fetch times go in TRANSPORT_LATENCY_BUCKETS buckets this many
+// microseconds wide, plus one for anything slower
+#define TRANSPORT_LATENCY_STEP    128
+#define TRANSPORT_LATENCY_BUCKETS 8
+
+typedef struct {
+  uint32_t transactions;   // started by the master
+  uint32_t failures;       // no answer or a broken packet
+  uint32_t retries;        // matrix transactions tried again in the same scan
+  uint32_t recovered;      // retries that got through
+  uint32_t parity_errors;  // in packets this half received
+  uint32_t latency[TRANSPORT_LATENCY_BUCKETS + 1]; // scans by matrix fetch time
+} transport_link_stats_t;
+
+void transport_get_link_stats(transport_link_stats_t *stats);
+void transport_reset_link_stats(void);
+// the fetch time in us that percent of the scans stayed within, rounded up
+// to the bucket, UINT16_MAX when past the last one and 0 without any scans
+uint16_t transport_link_latency(const transport_link_stats_t *stats, uint8_t percent);
+// prints the stats to the console
+void transport_print_link_stats(void);
+#endif
@@ -0,0 +1,121 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <string>
+#include <vector>
+
+using testing::_;
+using testing::Invoke;
+
+namespace {
+    enum { A, E, H, T, Z, SPC };
+
+    struct TraceEvent {
+        unsigned time;
+        uint8_t col;
+        bool pressed;
+    };
+}
+
+class AutoShift : public TestFixture {
+protected:
+    // Replays a recorded trace, running one scan per millisecond, and
+    // returns what was typed up to end_time
+    std::string replay(const std::vector<TraceEvent>& trace, unsigned end_time) {
+        TestDriver driver;
+        HostDecoder decoder;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke(std::ref(decoder)));
+        auto event = trace.begin();
+        for (unsigned t = 0; t <= end_time; t++) {
+            for (; event != trace.end() && event->time == t; ++event) {
+                if (event->pressed) {
+                    press_key(event->col, 0);
+                } else {
+                    release_key(event->col, 0);
+                }
+            }
+            run_one_scan_loop();
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+        return decoder.typed;
+    }
+};
+
+TEST_F(AutoShift, TapsAreNotShifted) {
+    EXPECT_EQ(replay({
+        {0, H, true}, {60, H, false},
+        {80, A, true}, {150, A, false},
+    }, 400), "ha");
+}
+
+TEST_F(AutoShift, KeyHeldPastTheTimeoutIsSentWithoutWaitingForRelease) {
+    EXPECT_EQ(replay({
+        {0, A, true},
+    }, AUTO_SHIFT_TIMEOUT), "");
+    EXPECT_EQ(replay({}, 1), "A");
+    EXPECT_EQ(replay({
+        {0, A, false},
+    }, 10), "");
+}
+
+TEST_F(AutoShift, ReleaseIsSentImmediately) {
+    EXPECT_EQ(replay({
+        {0, E, true}, {50, E, false},
+    }, 50), "e");
+}
+
+TEST_F(AutoShift, RolledTypingKeepsThePressOrder) {
+    // A fast typist's "the", every key overlaps the next one
+    EXPECT_EQ(replay({
+        {0, T, true}, {40, H, true}, {70, T, false},
+        {90, E, true}, {110, H, false}, {160, E, false},
+    }, 400), "the");
+}
+
+TEST_F(AutoShift, RolledShiftedKeyIsDecidedByItsOwnHoldTime) {
+    // T is held long enough to be shifted, even though H is pressed before
+    // T is released. H is released first but still comes out after T.
+    EXPECT_EQ(replay({
+        {0, T, true}, {100, H, true}, {150, H, false}, {200, T, false},
+        {250, E, true}, {300, E, false},
+    }, 500), "The");
+}
+
+TEST_F(AutoShift, OtherKeysSendPendingKeysFirst) {
+    EXPECT_EQ(replay({
+        {0, A, true}, {30, SPC, true}, {60, A, false}, {90, SPC, false},
+    }, 300), "a ");
+}
+
+TEST_F(AutoShift, PerKeyTimeoutsAreUsed) {
+    EXPECT_EQ(replay({
+        {0, Z, true}, {250, Z, false},
+        {300, A, true}, {550, A, false},
+        {600, Z, true}, {950, Z, false},
+    }, 1000), "zAZ");
+}
+
+TEST_F(AutoShift, ReleasingAKeyDroppedFromAFullQueueDecidesNothing) {
+    // A is sent and then dropped to make room for Z. Its release mustn't
+    // decide the keys rolled after it, E is still held long enough.
+    EXPECT_EQ(replay({
+        {0, A, true},
+        {200, E, true}, {210, H, true}, {220, T, true}, {230, Z, true},
+        {240, A, false}, {250, H, false}, {260, T, false}, {270, Z, false},
+        {400, E, false},
+    }, 600), "AEhtz");
+}
@@ -0,0 +1,216 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <vector>
+
+extern "C" {
+    #include "quantum.h"
+    #include "i2c_master.h"
+    #include "i2c_queue.h"
+
+    extern uint8_t g_pwm_buffer[DRIVER_COUNT][144];
+}
+
+// Simulated bus: nothing moves until the test, or a waiting queue, lets the
+// bus finish a transaction. Finished transfers are recorded and also passed
+// on to the i2c_master mock so the driver register images stay up to date.
+struct transfer {
+    uint8_t address;
+    std::vector<uint8_t> data;
+};
+
+static std::vector<transfer> bus_log;
+static uint32_t bus_kicks;
+static uint32_t bus_waits;
+static uint8_t bus_fail_transfer = 0xFF;
+
+static bool bus_step() {
+    uint8_t address;
+    const uint8_t *data;
+    uint16_t length;
+
+    if (!i2c_queue_next(&address, &data, &length)) {
+        return false;
+    }
+
+    bus_log.push_back({address, std::vector<uint8_t>(data, data + length)});
+    std::vector<uint8_t> copy(data, data + length);
+    i2c_transmit(address, copy.data(), length, 0);
+
+    i2c_queue_complete(bus_log.size() - 1 == bus_fail_transfer ? 1 : I2C_QUEUE_STATUS_OK);
+    return true;
+}
+
+extern "C" void i2c_queue_bus_kick(void) {
+    bus_kicks++;
+}
+
+extern "C" void i2c_queue_bus_wait(void) {
+    bus_waits++;
+    bus_step();
+}
+
+struct callback_record {
+    uint8_t status;
+    intptr_t arg;
+};
+
+static std::vector<callback_record> callbacks;
+
+static void record_callback(uint8_t status, void *arg) {
+    callbacks.push_back({status, (intptr_t)arg});
+}
+
+class I2cQueue : public testing::Test {
+protected:
+    void SetUp() override {
+        i2c_queue_flush();
+        bus_log.clear();
+        callbacks.clear();
+        bus_kicks = 0;
+        bus_waits = 0;
+        bus_fail_transfer = 0xFF;
+        i2c_mock_reset();
+    }
+};
+
+TEST_F(I2cQueue, WriteReturnsBeforeTheBusDoesAnything) {
+    uint8_t data[] = {1, 2, 3};
+    EXPECT_TRUE(i2c_queue_write(0x74 << 1, 0x24, data, sizeof(data), NULL, NULL));
+    EXPECT_EQ(bus_log.size(), 0);
+    EXPECT_EQ(bus_waits, 0);
+    EXPECT_GT(bus_kicks, 0);
+    EXPECT_FALSE(i2c_queue_is_idle());
+}
+
+TEST_F(I2cQueue, TransfersGoOutInOrderWithTheRegisterFirst) {
+    uint8_t data[2];
+    for (uint8_t i = 0; i < 5; i++) {
+        // the queue owns a copy, so the buffer can be reused straight away
+        data[0] = i;
+        data[1] = i * 2;
+        i2c_queue_write(0x20 + i, 0x10 + i, data, sizeof(data), NULL, NULL);
+    }
+    i2c_queue_flush();
+
+    ASSERT_EQ(bus_log.size(), 5);
+    for (uint8_t i = 0; i < 5; i++) {
+        EXPECT_EQ(bus_log[i].address, 0x20 + i);
+        EXPECT_EQ(bus_log[i].data, std::vector<uint8_t>({(uint8_t)(0x10 + i), i, (uint8_t)(i * 2)}));
+    }
+}
+
+TEST_F(I2cQueue, CallbacksRunFromTheTaskWithTheirStatus) {
+    uint8_t data = 0;
+    bus_fail_transfer = 1;
+    for (intptr_t i = 0; i < 3; i++) {
+        i2c_queue_write(0x40, 0, &data, 1, record_callback, (void *)i);
+    }
+
+    while (bus_step()) {
+    }
+    EXPECT_EQ(callbacks.size(), 0);
+
+    i2c_queue_task();
+    ASSERT_EQ(callbacks.size(), 3);
+    EXPECT_EQ(callbacks[0].arg, 0);
+    EXPECT_EQ(callbacks[0].status, I2C_QUEUE_STATUS_OK);
+    EXPECT_EQ(callbacks[1].arg, 1);
+    EXPECT_NE(callbacks[1].status, I2C_QUEUE_STATUS_OK);
+    EXPECT_EQ(callbacks[2].arg, 2);
+    EXPECT_EQ(callbacks[2].status, I2C_QUEUE_STATUS_OK);
+    EXPECT_TRUE(i2c_queue_is_idle());
+}
+
+TEST_F(I2cQueue, FlushWaitsForEveryTransaction) {
+    uint8_t data[4] = {0};
+    for (intptr_t i = 0; i < 4; i++) {
+        i2c_queue_write(0x40, 0, data, sizeof(data), record_callback, (void *)i);
+    }
+    bus_step();
+
+    i2c_queue_flush();
+    EXPECT_TRUE(i2c_queue_is_idle());
+    EXPECT_EQ(bus_log.size(), 4);
+    EXPECT_EQ(callbacks.size(), 4);
+}
+
+TEST_F(I2cQueue, FullQueueWaitsForTheBus) {
+    uint8_t data = 0;
+    for (uint8_t i = 0; i < I2C_QUEUE_SIZE; i++) {
+        i2c_queue_write(0x40, i, &data, 1, NULL, NULL);
+    }
+    EXPECT_EQ(bus_waits, 0);
+
+    i2c_queue_write(0x40, I2C_QUEUE_SIZE, &data, 1, NULL, NULL);
+    EXPECT_EQ(bus_waits, 1);
+    EXPECT_EQ(bus_log.size(), 1);
+
+    i2c_queue_flush();
+    ASSERT_EQ(bus_log.size(), I2C_QUEUE_SIZE + 1);
+    for (uint8_t i = 0; i <= I2C_QUEUE_SIZE; i++) {
+        EXPECT_EQ(bus_log[i].data[0], i);
+    }
+}
+
+TEST_F(I2cQueue, DataBufferWrapsAround) {
+    uint8_t data[40];
+    for (uint8_t n = 0; n < 20; n++) {
+        for (uint8_t i = 0; i < sizeof(data); i++) {
+            data[i] = n + i;
+        }
+        i2c_queue_write(0x40, n, data, sizeof(data), NULL, NULL);
+        // let the bus fall behind by a couple of transactions
+        if (n % 2) {
+            bus_step();
+            i2c_queue_task();
+        }
+    }
+    i2c_queue_flush();
+
+    ASSERT_EQ(bus_log.size(), 20);
+    for (uint8_t n = 0; n < 20; n++) {
+        ASSERT_EQ(bus_log[n].data.size(), sizeof(data) + 1);
+        EXPECT_EQ(bus_log[n].data[0], n);
+        for (uint8_t i = 0; i < sizeof(data); i++) {
+            EXPECT_EQ(bus_log[n].data[1 + i], (uint8_t)(n + i)) << "transfer " << (int)n << ", byte " << (int)i;
+        }
+    }
+}
+
+TEST_F(I2cQueue, TransferLargerThanTheBufferIsRejected) {
+    uint8_t data[I2C_QUEUE_BUFFER_SIZE] = {0};
+    EXPECT_FALSE(i2c_queue_write(0x40, 0, data, sizeof(data), NULL, NULL));
+    EXPECT_TRUE(i2c_queue_is_idle());
+}
+
+TEST_F(I2cQueue, LedDriverUpdatesAreQueued) {
+    rgb_matrix_driver.init();
+    i2c_queue_flush();
+    i2c_mock_reset();
+
+    IS31FL3731_set_color(0, 10, 20, 30);
+    IS31FL3731_update_pwm_buffers(DRIVER_ADDR_1, DRIVER_ADDR_2);
+    EXPECT_EQ(i2c_mock_transfers, 0);
+    EXPECT_FALSE(i2c_queue_is_idle());
+
+    i2c_queue_flush();
+    EXPECT_EQ(i2c_mock_transfers, 1);
+    for (int i = 0; i < 144; i++) {
+        EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, 0, 0x24 + i), g_pwm_buffer[0][i]) << "register " << i;
+    }
+}
@@ -0,0 +1,191 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "quantum.h"
+    #include "i2c_master.h"
+
+    extern uint8_t g_pwm_buffer[DRIVER_COUNT][144];
+}
+
+// What a flush of both drivers cost before dirty tracking: 9 transfers of
+// 16 registers plus the register address per driver
+static const uint32_t FULL_FLUSH_BYTES = 2 * 9 * 17;
+
+class Is31fl3731 : public testing::Test {
+protected:
+    void SetUp() override {
+        i2c_mock_reset();
+        rgb_matrix_driver.init();
+        IS31FL3731_set_color_all(0, 0, 0);
+        rgb_matrix_set_color_all(0, 0, 0);
+        flush();
+        i2c_mock_reset();
+    }
+
+    void flush() {
+        IS31FL3731_update_pwm_buffers(DRIVER_ADDR_1, DRIVER_ADDR_2);
+    }
+
+    void expect_device_matches_buffer() {
+        for (int i = 0; i < 144; i++) {
+            EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, 0, 0x24 + i), g_pwm_buffer[0][i]) << "driver 1, register " << i;
+            EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_2, 0, 0x24 + i), g_pwm_buffer[1][i]) << "driver 2, register " << i;
+        }
+    }
+};
+
+TEST_F(Is31fl3731, FlushSendsOnlyTheChangedBlock) {
+    IS31FL3731_set_color(0, 10, 20, 30);
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 1);
+    EXPECT_EQ(i2c_mock_bytes, 17);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, FlushWithoutChangesSendsNothing) {
+    flush();
+    IS31FL3731_set_color(3, 0, 0, 0);
+    IS31FL3731_set_color_all(0, 0, 0);
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 0);
+}
+
+TEST_F(Is31fl3731, AdjacentBlocksAreMerged) {
+    // LEDs 0 and 2 are in blocks 0 and 1
+    IS31FL3731_set_color(0, 1, 2, 3);
+    IS31FL3731_set_color(2, 4, 5, 6);
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 1);
+    EXPECT_EQ(i2c_mock_bytes, 33);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, SeparateBlocksAreSentSeparately) {
+    // LEDs 0 and 4 are in blocks 0 and 2
+    IS31FL3731_set_color(0, 1, 2, 3);
+    IS31FL3731_set_color(4, 4, 5, 6);
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 2);
+    EXPECT_EQ(i2c_mock_bytes, 34);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, FailedBlockIsSentAgain) {
+    // LEDs 0 and 4 are in blocks 0 and 2, the first one fails
+    IS31FL3731_set_color(0, 1, 2, 3);
+    IS31FL3731_set_color(4, 4, 5, 6);
+    i2c_mock_failing_register = 0x24;
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 1);
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, 0, 0x24 + 4 * 9), 4);
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, 0, 0x24), 0);
+
+    i2c_mock_failing_register = -1;
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 2);
+    expect_device_matches_buffer();
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 2);
+}
+
+TEST_F(Is31fl3731, EachDriverGetsItsOwnBlocks) {
+    IS31FL3731_set_color(DRIVER_1_LED_TOTAL + 15, 7, 8, 9);
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 1);
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_2, 0, 0x24 + 15 * 9), 7);
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, 0, 0x24 + 15 * 9), 0);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, FullUpdateIsOneTransferPerDriver) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        IS31FL3731_set_color(i, i + 1, i + 2, i + 3);
+    }
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 2);
+    EXPECT_EQ(i2c_mock_bytes, 2 * 145);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, BlockFlushSendsOneBlockPerCall) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        IS31FL3731_set_color(i, i + 1, i + 2, i + 3);
+    }
+    int calls = 0;
+    bool more = true;
+    while (more) {
+        uint32_t bytes = i2c_mock_bytes;
+        more = IS31FL3731_update_pwm_block(DRIVER_ADDR_1, DRIVER_ADDR_2);
+        EXPECT_EQ(i2c_mock_bytes - bytes, 17);
+        calls++;
+    }
+    EXPECT_EQ(calls, 2 * 9);
+    expect_device_matches_buffer();
+    EXPECT_FALSE(IS31FL3731_update_pwm_block(DRIVER_ADDR_1, DRIVER_ADDR_2));
+    EXPECT_EQ(i2c_mock_transfers, 2 * 9);
+}
+
+TEST_F(Is31fl3731, StaticEffectTrafficDropsTenfold) {
+    for (int frame = 0; frame < 100; frame++) {
+        IS31FL3731_set_color_all(50, 100, 150);
+        flush();
+    }
+    EXPECT_LE(i2c_mock_bytes * 10, 100 * FULL_FLUSH_BYTES);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, SlowEffectTrafficDropsTenfold) {
+    // One LED changes per frame, as in the raindrops effect
+    for (int frame = 0; frame < 100; frame++) {
+        IS31FL3731_set_color((frame * 5) % DRIVER_LED_TOTAL, frame, 255 - frame, frame / 2);
+        flush();
+    }
+    EXPECT_LE(i2c_mock_bytes * 10, 100 * FULL_FLUSH_BYTES);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, FrameBufferReachesTheDriverOnFlush) {
+    rgb_matrix_set_color(0, 10, 20, 30);
+    rgb_matrix_set_color(DRIVER_1_LED_TOTAL + 3, 40, 50, 60);
+    EXPECT_EQ(g_pwm_buffer[0][0], 0);
+    EXPECT_EQ(g_rgb_frame_buffer[0].g, 20);
+
+    rgb_matrix_update_pwm_buffers();
+    EXPECT_EQ(i2c_mock_transfers, 2);
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, 0, 0x24), 10);
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_2, 0, 0x24 + 3 * 9 + 2), 60);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3731, FrameBufferMatchesPerLedColors) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        rgb_matrix_set_color(i, i * 3, 255 - i, i * 7);
+    }
+    rgb_matrix_update_pwm_buffers();
+
+    expect_device_matches_buffer();
+
+    // setting the same colors one LED at a time leaves nothing to send
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        IS31FL3731_set_color(i, i * 3, 255 - i, i * 7);
+    }
+    i2c_mock_reset();
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 0);
+}
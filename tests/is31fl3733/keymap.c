@@ -0,0 +1,46 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+#define KEY_LED(i) { { ((i) / MATRIX_COLS) | (((i) % MATRIX_COLS) << 4) }, { ((i) % MATRIX_COLS) * 32, ((i) / MATRIX_COLS) * 21 }, 0 }
+#define KEY_LED_ROW(row) \
+    KEY_LED(row * 8 + 0), KEY_LED(row * 8 + 1), KEY_LED(row * 8 + 2), KEY_LED(row * 8 + 3), \
+    KEY_LED(row * 8 + 4), KEY_LED(row * 8 + 5), KEY_LED(row * 8 + 6), KEY_LED(row * 8 + 7)
+
+const rgb_led g_rgb_leds[DRIVER_LED_TOTAL] = {
+    KEY_LED_ROW(0), KEY_LED_ROW(1), KEY_LED_ROW(2), KEY_LED_ROW(3)
+};
+
+// Every LED takes three adjacent PWM registers, spread six registers apart
+// so each 16 byte block holds two or three of them
+#define ISSI_LED(i) { 0, (i) * 6, (i) * 6 + 1, (i) * 6 + 2 }
+#define ISSI_LED_ROW(row) \
+    ISSI_LED(row * 8 + 0), ISSI_LED(row * 8 + 1), ISSI_LED(row * 8 + 2), ISSI_LED(row * 8 + 3), \
+    ISSI_LED(row * 8 + 4), ISSI_LED(row * 8 + 5), ISSI_LED(row * 8 + 6), ISSI_LED(row * 8 + 7)
+
+const is31_led g_is31_leds[DRIVER_LED_TOTAL] = {
+    ISSI_LED_ROW(0), ISSI_LED_ROW(1), ISSI_LED_ROW(2), ISSI_LED_ROW(3)
+};
@@ -0,0 +1,143 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+    #include "quantum.h"
+    #include "i2c_master.h"
+
+    extern uint8_t g_pwm_buffer[DRIVER_COUNT][192];
+}
+
+#define ISSI_PAGE_PWM 0x01
+
+// What a flush cost before dirty tracking: unlocking and selecting the PWM
+// page, then 12 transfers of 16 registers plus the register address
+static const uint32_t FULL_FLUSH_BYTES = 2 * 2 + 12 * 17;
+
+class Is31fl3733 : public testing::Test {
+protected:
+    void SetUp() override {
+        i2c_mock_reset();
+        rgb_matrix_driver.init();
+        IS31FL3733_set_color_all(0, 0, 0);
+        flush();
+        i2c_mock_reset();
+    }
+
+    void flush() {
+        IS31FL3733_update_pwm_buffers(DRIVER_ADDR_1, DRIVER_ADDR_2);
+    }
+
+    void expect_device_matches_buffer() {
+        for (int i = 0; i < 192; i++) {
+            EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, ISSI_PAGE_PWM, i), g_pwm_buffer[0][i]) << "register " << i;
+        }
+    }
+};
+
+TEST_F(Is31fl3733, FlushSendsOnlyTheChangedBlock) {
+    IS31FL3733_set_color(0, 10, 20, 30);
+    flush();
+    // Unlock, page select and one block
+    EXPECT_EQ(i2c_mock_transfers, 3);
+    EXPECT_EQ(i2c_mock_bytes, 2 + 2 + 17);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3733, FlushWithoutChangesSendsNothing) {
+    flush();
+    IS31FL3733_set_color_all(0, 0, 0);
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 0);
+}
+
+TEST_F(Is31fl3733, AdjacentBlocksAreMerged) {
+    // LEDs 0 and 3 are in blocks 0 and 1
+    IS31FL3733_set_color(0, 1, 2, 3);
+    IS31FL3733_set_color(3, 4, 5, 6);
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 3);
+    EXPECT_EQ(i2c_mock_bytes, 2 + 2 + 33);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3733, FailedBlockIsSentAgain) {
+    // LEDs 0 and 8 are in blocks 0 and 3, the first one fails
+    IS31FL3733_set_color(0, 1, 2, 3);
+    IS31FL3733_set_color(8, 4, 5, 6);
+    i2c_mock_failing_register = 0x00;
+    flush();
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, ISSI_PAGE_PWM, 8 * 6), 4);
+    EXPECT_EQ(i2c_mock_register(DRIVER_ADDR_1, ISSI_PAGE_PWM, 0), 0);
+
+    i2c_mock_failing_register = -1;
+    i2c_mock_transfers = 0;
+    flush();
+    // Unlock, page select and the failed block
+    EXPECT_EQ(i2c_mock_transfers, 3);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3733, BlockFlushSendsOneBlockPerCall) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        IS31FL3733_set_color(i, i + 1, i + 2, i + 3);
+    }
+    int calls = 0;
+    bool more = true;
+    while (more) {
+        uint32_t bytes = i2c_mock_bytes;
+        more = IS31FL3733_update_pwm_block(DRIVER_ADDR_1, DRIVER_ADDR_2);
+        // Unlock, page select and one block
+        EXPECT_EQ(i2c_mock_bytes - bytes, 2 + 2 + 17);
+        calls++;
+    }
+    EXPECT_EQ(calls, 12);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3733, StaticEffectSendsNothingAfterTheFirstFrame) {
+    IS31FL3733_set_color_all(50, 100, 150);
+    flush();
+    uint32_t first_frame = i2c_mock_bytes;
+    for (int frame = 0; frame < 100; frame++) {
+        IS31FL3733_set_color_all(50, 100, 150);
+        flush();
+    }
+    EXPECT_EQ(i2c_mock_bytes, first_frame);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3733, FullUpdateIsOneTransfer) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        IS31FL3733_set_color(i, i + 1, i + 2, i + 3);
+    }
+    flush();
+    EXPECT_EQ(i2c_mock_transfers, 3);
+    expect_device_matches_buffer();
+}
+
+TEST_F(Is31fl3733, SlowEffectTrafficDrops) {
+    // One LED changes per frame. The unlock and page select are needed on
+    // every flush, which keeps this just short of a tenfold drop.
+    for (int frame = 0; frame < 100; frame++) {
+        IS31FL3733_set_color((frame * 5) % DRIVER_LED_TOTAL, frame, 255 - frame, frame / 2);
+        flush();
+    }
+    EXPECT_LE(i2c_mock_bytes * 8, 100 * FULL_FLUSH_BYTES);
+    expect_device_matches_buffer();
+}
@@ -0,0 +1,52 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        // 0     1      2      3      4      5      6      7      8      9
+        {KC_LEAD, KC_A,  KC_B,  KC_C,  KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,   KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+const uint16_t PROGMEM leader_a[] = {KC_A, LEADER_SEQ_END};
+const uint16_t PROGMEM leader_ba[] = {KC_B, KC_A, LEADER_SEQ_END};
+const uint16_t PROGMEM leader_bac[] = {KC_B, KC_A, KC_C, LEADER_SEQ_END};
+const uint16_t PROGMEM leader_bb[] = {KC_B, KC_B, LEADER_SEQ_END};
+
+// Deliberately unsorted, the sequences starting with B are split up by
+// leader_a and leader_ba comes after the longer leader_bac
+const uint16_t * const leader_sequences[LEADER_SEQUENCE_COUNT] PROGMEM = {
+    leader_bb,
+    leader_a,
+    leader_bac,
+    leader_ba,
+};
+
+int16_t matched_leader_sequence = -1;
+uint8_t leader_end_count = 0;
+
+void process_leader_sequence(uint8_t sequence_index) {
+    matched_leader_sequence = sequence_index;
+}
+
+void leader_end(void) {
+    leader_end_count++;
+}
@@ -0,0 +1,103 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+
+using testing::AnyNumber;
+
+extern "C" {
+    extern bool leading;
+    extern int16_t matched_leader_sequence;
+    extern uint8_t leader_end_count;
+}
+
+class Leader : public TestFixture {
+protected:
+    void SetUp() override {
+        matched_leader_sequence = -1;
+        leader_end_count = 0;
+    }
+
+    void tap_key(uint8_t col) {
+        press_key(col, 0);
+        run_one_scan_loop();
+        release_key(col, 0);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(Leader, UniqueMatchFinishesWithoutTheTimeout) {
+    TestDriver driver;
+    // Releases are passed through, but nothing is pressed
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap_key(0);
+    EXPECT_TRUE(leading);
+    tap_key(1);
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(matched_leader_sequence, 1);
+    EXPECT_EQ(leader_end_count, 1);
+}
+
+TEST_F(Leader, PrefixOfALongerSequenceMatchesAtTheTimeout) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap_key(0);
+    tap_key(2);
+    tap_key(1);
+    EXPECT_TRUE(leading);
+    idle_for(LEADER_TIMEOUT);
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(matched_leader_sequence, 3);
+    EXPECT_EQ(leader_end_count, 1);
+}
+
+TEST_F(Leader, LongerSequenceIsMatchedImmediately) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap_key(0);
+    tap_key(2);
+    tap_key(1);
+    tap_key(3);
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(matched_leader_sequence, 2);
+}
+
+TEST_F(Leader, SiblingSequenceIsMatched) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap_key(0);
+    tap_key(2);
+    tap_key(2);
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(matched_leader_sequence, 0);
+}
+
+TEST_F(Leader, UnknownSequenceEndsImmediately) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap_key(0);
+    tap_key(2);
+    tap_key(3);
+    EXPECT_FALSE(leading);
+    EXPECT_EQ(matched_leader_sequence, -1);
+    EXPECT_EQ(leader_end_count, 1);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // Keys after the sequence are sent normally
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    tap_key(3);
+}
@@ -0,0 +1,31 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_RGB_MATRIX_CONFIG_H_
+#define TESTS_RGB_MATRIX_CONFIG_H_
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+#define DRIVER_LED_TOTAL 42
+#define LED_HITS_TO_REMEMBER 16
+
+#define RGB_MATRIX_FRAMERATE 50
+#define RGB_MATRIX_LED_PROCESS_LIMIT 16
+
+#define RGB_MATRIX_EFFECT_CACHE
+
+#endif /* TESTS_RGB_MATRIX_CONFIG_H_ */
@@ -0,0 +1,90 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+// One LED per key, spread over the whole 224x64 area the effects expect
+#define LED(row, col) { { (row) | ((col) << 4) }, { (col) * 224 / 9, (row) * 64 / 3 }, 0 }
+#define LED_ROW(row) \
+    LED(row, 0), LED(row, 1), LED(row, 2), LED(row, 3), LED(row, 4), \
+    LED(row, 5), LED(row, 6), LED(row, 7), LED(row, 8), LED(row, 9)
+
+const rgb_led g_rgb_leds[DRIVER_LED_TOTAL] = {
+    LED_ROW(0), LED_ROW(1), LED_ROW(2), LED_ROW(3),
+    // A second LED under the top left key, and one underglow LED
+    { { 0 | (0 << 4) }, { 12, 10 }, 0 },
+    { { 0xFF }, { 112, 64 }, 0 },
+};
+
+RGB test_leds[DRIVER_LED_TOTAL];
+int test_set_color_count;
+int test_flush_count;
+// Like the ISSI drivers, the LEDs are sent in blocks and set_color marks
+// the block it touches dirty
+#define TEST_LEDS_PER_BLOCK 8
+uint8_t test_dirty_blocks;
+int test_block_count;
+
+static void init(void) {
+}
+
+static void set_color(int index, uint8_t r, uint8_t g, uint8_t b) {
+    test_set_color_count++;
+    test_leds[index].r = r;
+    test_leds[index].g = g;
+    test_leds[index].b = b;
+    test_dirty_blocks |= 1 << (index / TEST_LEDS_PER_BLOCK);
+}
+
+static void set_color_all(uint8_t r, uint8_t g, uint8_t b) {
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        set_color(i, r, g, b);
+    }
+}
+
+static void flush(void) {
+    test_dirty_blocks = 0;
+    test_flush_count++;
+}
+
+static bool flush_block(void) {
+    if (test_dirty_blocks) {
+        test_dirty_blocks &= test_dirty_blocks - 1;
+        test_block_count++;
+    }
+    if (test_dirty_blocks) {
+        return true;
+    }
+    test_flush_count++;
+    return false;
+}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init = init,
+    .flush = flush,
+    .set_color = set_color,
+    .set_color_all = set_color_all,
+    .flush_block = flush_block,
+};
@@ -0,0 +1,549 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <stdio.h>
+
+extern "C" {
+    #include "quantum.h"
+    #include "fixed_math.h"
+    #include "led_tables.h"
+
+    extern uint32_t g_tick;
+    extern rgb_config_t rgb_matrix_config;
+    extern RGB test_leds[DRIVER_LED_TOTAL];
+    extern uint8_t g_key_hit[DRIVER_LED_TOTAL];
+    extern uint8_t g_last_led_count;
+    extern int test_set_color_count;
+    extern int test_flush_count;
+    extern int test_block_count;
+
+    void advance_time(uint32_t ms);
+
+    void rgb_matrix_dual_beacon(void);
+    void rgb_matrix_rainbow_beacon(void);
+    void rgb_matrix_rainbow_pinwheels(void);
+    void rgb_matrix_rainbow_moving_chevron(void);
+    void rgb_matrix_multisplash(void);
+    void rgb_matrix_solid_multisplash(void);
+    void rgb_matrix_cycle_all(void);
+    void rgb_matrix_cycle_left_right(void);
+    void rgb_matrix_cycle_up_down(void);
+    void rgb_matrix_gradient_up_down(void);
+    void map_row_column_to_led(uint8_t row, uint8_t column, uint8_t *led_i, uint8_t *led_count);
+}
+
+// The floating point versions of the effects, as they were before the switch
+// to fixed_math. Each returns the unwrapped hue of one LED.
+typedef double (*reference_hue_t)(Point point, double speed);
+
+static double dual_beacon(Point point, double speed) {
+    double cos_value = cos(g_tick * M_PI / 128) / 32;
+    double sin_value = sin(g_tick * M_PI / 128) / 112;
+    return ((point.y - 32.0) * cos_value + (point.x - 112.0) * sin_value) * 180;
+}
+
+static double rainbow_beacon(Point point, double speed) {
+    double cos_value = cos(g_tick * M_PI / 128);
+    double sin_value = sin(g_tick * M_PI / 128);
+    return 1.5 * speed * (point.y - 32.0) * cos_value + 1.5 * speed * (point.x - 112.0) * sin_value;
+}
+
+static double rainbow_pinwheels(Point point, double speed) {
+    double cos_value = cos(g_tick * M_PI / 128);
+    double sin_value = sin(g_tick * M_PI / 128);
+    return 2 * speed * (point.y - 32.0) * cos_value + 2 * speed * (66 - fabs(point.x - 112.0)) * sin_value;
+}
+
+static double rainbow_moving_chevron(Point point, double speed) {
+    double cos_value = cos(128 * M_PI / 128);
+    double sin_value = sin(128 * M_PI / 128);
+    double multiplier = g_tick / 256.0 * 224;
+    return 1.5 * speed * fabs(point.y - 32.0) * sin_value + 1.5 * speed * (point.x - multiplier) * cos_value;
+}
+
+class RgbMatrix : public testing::Test {
+protected:
+    void SetUp() override {
+        rgb_matrix_init();
+        rgb_matrix_config.hue = 0;
+        rgb_matrix_config.sat = 255;
+        rgb_matrix_config.val = 255;
+        rgb_matrix_config.speed = 0;
+        g_tick = 0;
+        g_last_led_count = 0;
+        memset(g_key_hit, 255, sizeof(g_key_hit));
+    }
+
+    void hit_led(uint8_t led) {
+        keyrecord_t record = {};
+        record.event.key.row = g_rgb_leds[led].matrix_co.row;
+        record.event.key.col = g_rgb_leds[led].matrix_co.col;
+        record.event.pressed = true;
+        process_rgb_matrix(KC_NO, &record);
+    }
+
+    // The splash ring of one hit as computed with libm, before the switch to
+    // integer distances
+    static uint16_t splash_effect(uint8_t led, uint8_t hit) {
+        Point point = g_rgb_leds[led].point;
+        Point hit_point = g_rgb_leds[hit].point;
+        uint16_t dist = (uint16_t)sqrt(pow(point.x - hit_point.x, 2) + pow(point.y - hit_point.y, 2));
+        uint16_t effect = (g_key_hit[hit] << 2) - dist;
+        return std::min<int>(effect, 255);
+    }
+
+    void expect_rgb(int index, HSV hsv) {
+        RGB expected = hsv_to_rgb(hsv);
+        const RGB &actual = test_leds[index];
+        EXPECT_TRUE(actual.r == expected.r && actual.g == expected.g && actual.b == expected.b)
+            << "LED " << index << " is (" << (int)actual.r << ", " << (int)actual.g << ", " << (int)actual.b
+            << "), expected (" << (int)expected.r << ", " << (int)expected.g << ", " << (int)expected.b << ")";
+    }
+
+    // Hits LEDs in order and then ages every hit by a different amount, so
+    // the rings are spread out across the board.
+    void hit_leds(const std::vector<uint8_t> &leds, uint8_t age) {
+        for (uint8_t led : leds) {
+            hit_led(led);
+        }
+        for (size_t i = 0; i < leds.size(); i++) {
+            g_key_hit[leds[i]] = std::min<int>(age + 9 * (leds.size() - i), 254);
+        }
+    }
+
+    // Runs the effect for a range of ticks and speeds and checks that every
+    // LED is within one hue step of the floating point result. At higher
+    // speeds the error of sin16() is scaled up too, so allow more steps.
+    void expect_matches(void (*effect)(void), reference_hue_t reference, uint32_t ticks) {
+        for (uint8_t speed = 0; speed <= 3; speed++) {
+            expect_matches_at(effect, reference, ticks, speed);
+        }
+    }
+
+    void expect_matches_at(void (*effect)(void), reference_hue_t reference, uint32_t ticks, uint8_t speed, int steps = 1) {
+        for (uint16_t hue = 0; hue < 360; hue += 45) {
+            rgb_matrix_config.speed = speed;
+            rgb_matrix_config.hue = hue;
+            for (g_tick = 0; g_tick < ticks; g_tick++) {
+                effect();
+                for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+                    double h = reference(g_rgb_leds[i].point, speed == 0 ? 1 : speed) + hue;
+                    expect_close(i, (uint8_t)(int32_t)h, steps);
+                }
+            }
+        }
+    }
+
+    void expect_close(int index, uint8_t hue, int steps = 1) {
+        const RGB &actual = test_leds[index];
+        for (int delta = -steps; delta <= steps; delta++) {
+            HSV hsv = { .h = (uint8_t)(hue + delta), .s = rgb_matrix_config.sat, .v = rgb_matrix_config.val };
+            RGB expected = hsv_to_rgb(hsv);
+            if (actual.r == expected.r && actual.g == expected.g && actual.b == expected.b) {
+                return;
+            }
+        }
+        ADD_FAILURE() << "LED " << index << " at tick " << g_tick << ", speed " << (int)rgb_matrix_config.speed
+                      << " is (" << (int)actual.r << ", " << (int)actual.g << ", " << (int)actual.b
+                      << "), expected hue " << (int)hue;
+    }
+};
+
+TEST(FixedMath, SinAndCosMatchFloatingPoint) {
+    for (int theta = 0; theta < 256; theta++) {
+        EXPECT_NEAR(sin16(theta), 32767 * sin(theta * M_PI / 128), 1) << theta;
+        EXPECT_NEAR(cos16(theta), 32767 * cos(theta * M_PI / 128), 1) << theta;
+        EXPECT_NEAR(sin8(theta), 128 + 128 * sin(theta * M_PI / 128), 1) << theta;
+        EXPECT_NEAR(cos8(theta), 128 + 128 * cos(theta * M_PI / 128), 1) << theta;
+    }
+}
+
+TEST(FixedMath, Sqrt) {
+    for (uint32_t x = 0; x < 140000; x++) {
+        EXPECT_EQ(sqrt32(x), (uint16_t)sqrt(x)) << x;
+    }
+    EXPECT_EQ(sqrt32(0xFFFFFFFF), 0xFFFF);
+}
+
+TEST(FixedMath, Atan2MatchesFloatingPoint) {
+    for (int y = -224; y <= 224; y += 7) {
+        for (int x = -224; x <= 224; x += 5) {
+            double expected = atan2(y, x) * 128 / M_PI;
+            int8_t error = atan2_8(y, x) - (uint8_t)lround(expected);
+            EXPECT_LE(abs(error), 1) << x << ", " << y;
+        }
+    }
+}
+
+TEST(FixedMath, ScaleAndLerp) {
+    EXPECT_EQ(scale8(255, 128), 127);
+    EXPECT_EQ(scale8(100, 0), 0);
+    EXPECT_EQ(scale16by8(40000, 64), 10000);
+    EXPECT_EQ(lerp16by8(1000, 2000, 0), 1000);
+    EXPECT_EQ(lerp16by8(1000, 2000, 128), 1500);
+    EXPECT_EQ(lerp16by8(2000, 1000, 64), 1750);
+}
+
+// hsv_to_rgb as it was before the division was taken out
+static RGB reference_hsv_to_rgb(HSV hsv) {
+    RGB rgb;
+    if (hsv.s == 0) {
+        return { hsv.v, hsv.v, hsv.v };
+    }
+    uint16_t h = hsv.h, s = hsv.s, v = hsv.v;
+    uint8_t region = h / 43;
+    uint16_t remainder = (h - (region * 43)) * 6;
+    uint8_t p = (v * (255 - s)) >> 8;
+    uint8_t q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    uint8_t t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+    switch (region) {
+        case 0: rgb = { (uint8_t)v, t, p }; break;
+        case 1: rgb = { q, (uint8_t)v, p }; break;
+        case 2: rgb = { p, (uint8_t)v, t }; break;
+        case 3: rgb = { p, q, (uint8_t)v }; break;
+        case 4: rgb = { t, p, (uint8_t)v }; break;
+        default: rgb = { (uint8_t)v, p, q }; break;
+    }
+    return { CIE1931_CURVE[rgb.r], CIE1931_CURVE[rgb.g], CIE1931_CURVE[rgb.b] };
+}
+
+static bool same_rgb(RGB a, RGB b) {
+    return a.r == b.r && a.g == b.g && a.b == b.b;
+}
+
+TEST(Color, HsvToRgbMatchesReference) {
+    for (int h = 0; h < 256; h++) {
+        for (int s = 0; s < 256; s++) {
+            for (int v = 0; v < 256; v++) {
+                HSV hsv = { (uint8_t)h, (uint8_t)s, (uint8_t)v };
+                ASSERT_TRUE(same_rgb(hsv_to_rgb(hsv), reference_hsv_to_rgb(hsv))) << h << ", " << s << ", " << v;
+            }
+        }
+    }
+}
+
+TEST(Color, BatchConversionMatchesSingle) {
+    std::vector<HSV> hsv;
+    // runs sharing s and v, as the effects produce them, then noise
+    for (int v = 0; v < 256; v += 15) {
+        for (int s = 0; s < 256; s += 51) {
+            for (int h = 0; h < 256; h += 3) {
+                hsv.push_back({ (uint8_t)h, (uint8_t)s, (uint8_t)v });
+            }
+        }
+    }
+    srand(1);
+    for (int i = 0; i < 4096; i++) {
+        hsv.push_back({ (uint8_t)rand(), (uint8_t)(rand() % 3 ? rand() : 0), (uint8_t)rand() });
+    }
+
+    std::vector<RGB> rgb(hsv.size());
+    hsv_to_rgb_buffer(hsv.data(), rgb.data(), hsv.size());
+    for (size_t i = 0; i < hsv.size(); i++) {
+        ASSERT_TRUE(same_rgb(rgb[i], reference_hsv_to_rgb(hsv[i]))) << "color " << i;
+    }
+}
+
+// Not a pass/fail check, just prints how long 500 LEDs take each way
+TEST(Color, BenchmarkBatchConversion) {
+    const int leds = 500, frames = 2000;
+    HSV hsv[leds];
+    RGB rgb[leds];
+    for (int i = 0; i < leds; i++) {
+        hsv[i] = { (uint8_t)(i * 7), 255, 200 };
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        hsv[frame % leds].h++;
+        for (int i = 0; i < leds; i++) {
+            rgb[i] = reference_hsv_to_rgb(hsv[i]);
+        }
+    }
+    auto middle = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++) {
+        hsv[frame % leds].h++;
+        hsv_to_rgb_buffer(hsv, rgb, leds);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double single = std::chrono::duration<double, std::nano>(middle - start).count() / (frames * leds);
+    double batch = std::chrono::duration<double, std::nano>(end - middle).count() / (frames * leds);
+    printf("old hsv_to_rgb %.2f ns/LED, hsv_to_rgb_buffer %.2f ns/LED over %d LEDs\n", single, batch, leds);
+    EXPECT_GT(rgb[0].r + rgb[0].g + rgb[0].b, 0);
+}
+
+TEST_F(RgbMatrix, MapsKeysToTheirLeds) {
+    uint8_t leds[8], count;
+    map_row_column_to_led(0, 0, leds, &count);
+    ASSERT_EQ(count, 2);
+    EXPECT_EQ(leds[0], 0);
+    EXPECT_EQ(leds[1], 40);
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (row == 0 && col == 0) {
+                continue;
+            }
+            map_row_column_to_led(row, col, leds, &count);
+            ASSERT_EQ(count, 1);
+            EXPECT_EQ(leds[0], row * MATRIX_COLS + col);
+        }
+    }
+}
+
+TEST_F(RgbMatrix, PositionsOutsideTheMatrixHaveNoLeds) {
+    uint8_t leds[8], count = 1;
+    map_row_column_to_led(MATRIX_ROWS, 0, leds, &count);
+    EXPECT_EQ(count, 0);
+    count = 1;
+    map_row_column_to_led(0, MATRIX_COLS, leds, &count);
+    EXPECT_EQ(count, 0);
+    count = 1;
+    map_row_column_to_led(255, 255, leds, &count);
+    EXPECT_EQ(count, 0);
+}
+
+TEST_F(RgbMatrix, DualBeaconMatchesFloatingPoint) {
+    expect_matches(rgb_matrix_dual_beacon, dual_beacon, 256);
+}
+
+TEST_F(RgbMatrix, RainbowBeaconMatchesFloatingPoint) {
+    expect_matches(rgb_matrix_rainbow_beacon, rainbow_beacon, 256);
+}
+
+TEST_F(RgbMatrix, RainbowBeaconMatchesFloatingPointAtFullSpeed) {
+    expect_matches_at(rgb_matrix_rainbow_beacon, rainbow_beacon, 256, 255, 2);
+}
+
+TEST_F(RgbMatrix, RainbowPinwheelsMatchesFloatingPoint) {
+    expect_matches(rgb_matrix_rainbow_pinwheels, rainbow_pinwheels, 256);
+}
+
+TEST_F(RgbMatrix, RainbowMovingChevronMatchesFloatingPoint) {
+    expect_matches(rgb_matrix_rainbow_moving_chevron, rainbow_moving_chevron, 4096);
+}
+
+TEST_F(RgbMatrix, MultisplashMatchesFloatingPoint) {
+    std::vector<uint8_t> leds = {0, 39, 12, 27, 5, 34, 18, 21, 9, 30, 2, 37, 15, 24};
+    for (int age = 0; age < 255; age += 3) {
+        SetUp();
+        rgb_matrix_config.hue = age;
+        hit_leds(leds, age);
+        EXPECT_EQ(g_last_led_count, leds.size());
+        rgb_matrix_multisplash();
+        for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+            uint16_t c = 0, d = 0;
+            for (uint8_t hit : leds) {
+                c += splash_effect(i, hit);
+                d += 255 - splash_effect(i, hit);
+            }
+            expect_rgb(i, { .h = (uint8_t)((age + c) % 256), .s = 255, .v = (uint8_t)std::min<int>(d, 255) });
+        }
+    }
+}
+
+TEST_F(RgbMatrix, SolidMultisplashMatchesFloatingPoint) {
+    std::vector<uint8_t> leds = {3, 36, 19, 20, 7, 32};
+    for (int age = 0; age < 255; age += 5) {
+        SetUp();
+        hit_leds(leds, age);
+        rgb_matrix_solid_multisplash();
+        for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+            uint16_t d = 0;
+            for (uint8_t hit : leds) {
+                d += 255 - splash_effect(i, hit);
+            }
+            expect_rgb(i, { .h = 0, .s = 255, .v = (uint8_t)std::min<int>(d, 255) });
+        }
+    }
+}
+
+TEST_F(RgbMatrix, MultisplashForgetsOldestHits) {
+    std::vector<uint8_t> leds;
+    for (int i = 0; i < LED_HITS_TO_REMEMBER + 4; i++) {
+        leds.push_back(i);
+    }
+    hit_leds(leds, 20);
+    EXPECT_EQ(g_last_led_count, LED_HITS_TO_REMEMBER);
+    rgb_matrix_solid_multisplash();
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        uint16_t d = 0;
+        for (size_t hit = 4; hit < leds.size(); hit++) {
+            d += 255 - splash_effect(i, leds[hit]);
+        }
+        expect_rgb(i, { .h = 0, .s = 255, .v = (uint8_t)std::min<int>(d, 255) });
+    }
+}
+
+// The cycle effects as they were before the effect cache, one hue per LED
+static uint8_t cycle_hue(int axis, uint8_t led) {
+    uint8_t offset = (g_tick << rgb_matrix_config.speed) & 0xFF;
+    uint16_t offset2 = g_key_hit[led] << 2;
+    offset2 = (offset2 <= 63) ? (63 - offset2) : 0;
+    uint8_t base = axis == 0 ? 0 : axis == 1 ? g_rgb_leds[led].point.x : g_rgb_leds[led].point.y;
+    return base + offset + offset2;
+}
+
+TEST_F(RgbMatrix, CachedCycleEffectsMatchDirectConversion) {
+    void (*effects[])(void) = { rgb_matrix_cycle_all, rgb_matrix_cycle_left_right, rgb_matrix_cycle_up_down };
+    hit_leds({4, 17, 33}, 2);
+    for (int axis = 0; axis < 3; axis++) {
+        // changing the brightness between frames has to rebuild the cache
+        for (int val = 255; val >= 0; val -= 85) {
+            rgb_matrix_config.val = val;
+            for (uint8_t speed = 0; speed <= 3; speed++) {
+                rgb_matrix_config.speed = speed;
+                for (g_tick = 0; g_tick < 300; g_tick += 7) {
+                    effects[axis]();
+                    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+                        if (g_rgb_leds[i].matrix_co.raw < 0xFF) {
+                            expect_rgb(i, { .h = cycle_hue(axis, i), .s = 255, .v = (uint8_t)val });
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_F(RgbMatrix, CachedGradientFollowsTheConfig) {
+    for (uint16_t hue = 0; hue < 360; hue += 40) {
+        for (int sat = 255; sat >= 0; sat -= 51) {
+            rgb_matrix_config.hue = hue;
+            rgb_matrix_config.sat = sat;
+            rgb_matrix_config.val = 255 - hue / 2;
+            rgb_matrix_gradient_up_down();
+
+            int16_t deltaH = (int16_t)((hue + 180) % 360) - hue;
+            if (deltaH > 127) {
+                deltaH -= 256;
+            } else if (deltaH < -127) {
+                deltaH += 256;
+            }
+            deltaH /= 4;
+            int16_t deltaS = ((int16_t)hue - sat) / 4;
+            for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+                uint8_t y = g_rgb_leds[i].point.y >> 4;
+                expect_rgb(i, { .h = (uint8_t)(hue + deltaH * y), .s = (uint8_t)(sat + deltaS * y), .v = rgb_matrix_config.val });
+            }
+        }
+    }
+}
+
+class RgbMatrixTask : public RgbMatrix {
+protected:
+    void SetUp() override {
+        RgbMatrix::SetUp();
+        rgb_matrix_config.enable = true;
+        rgb_matrix_config.mode = RGB_MATRIX_DUAL_BEACON;
+        // Get through the startup delay and the first frame
+        for (int i = 0; i < 1000; i++) {
+            advance_time(1);
+            rgb_matrix_task();
+        }
+        rgb_matrix_reset_stats();
+        test_set_color_count = 0;
+        test_flush_count = 0;
+        test_block_count = 0;
+    }
+
+    // Runs scans 1 ms apart until the next flush, returns how many it took
+    int run_until_flush() {
+        int scans = 0;
+        int flushes = test_flush_count;
+        while (test_flush_count == flushes) {
+            advance_time(1);
+            rgb_matrix_task();
+            scans++;
+        }
+        return scans;
+    }
+};
+
+TEST_F(RgbMatrixTask, RendersInSlicesAtTheFrameRate) {
+    run_until_flush();
+    for (int frame = 0; frame < 10; frame++) {
+        int set_color_count = test_set_color_count;
+        uint32_t tick = g_tick;
+        EXPECT_EQ(run_until_flush(), 1000 / RGB_MATRIX_FRAMERATE);
+        EXPECT_EQ(g_tick, tick + 1);
+        EXPECT_EQ(test_set_color_count - set_color_count, DRIVER_LED_TOTAL);
+    }
+}
+
+TEST_F(RgbMatrixTask, RendersNoMoreThanTheLimitPerScan) {
+    for (int scan = 0; scan < 200; scan++) {
+        int set_color_count = test_set_color_count;
+        int flush_count = test_flush_count;
+        int block_count = test_block_count;
+        advance_time(1);
+        rgb_matrix_task();
+        EXPECT_LE(test_set_color_count - set_color_count, RGB_MATRIX_LED_PROCESS_LIMIT);
+        // Rendering and flushing never happen in the same scan
+        if (test_flush_count != flush_count || test_block_count != block_count) {
+            EXPECT_EQ(test_set_color_count, set_color_count);
+        }
+    }
+}
+
+TEST_F(RgbMatrixTask, SlicedFrameMatchesWholeFrame) {
+    run_until_flush();
+    RGB sliced[DRIVER_LED_TOTAL];
+    memcpy(sliced, test_leds, sizeof(sliced));
+    rgb_matrix_dual_beacon();
+    EXPECT_EQ(memcmp(sliced, test_leds, sizeof(sliced)), 0);
+}
+
+TEST_F(RgbMatrixTask, WholeFrameEffectsRenderOnce) {
+    rgb_matrix_config.mode = RGB_MATRIX_SOLID_COLOR;
+    run_until_flush();
+    run_until_flush();
+    for (int i = 0; i < DRIVER_LED_TOTAL; i++) {
+        EXPECT_EQ(test_leds[i].r, 255);
+    }
+    int set_color_count = test_set_color_count;
+    run_until_flush();
+    EXPECT_EQ(test_set_color_count - set_color_count, DRIVER_LED_TOTAL);
+}
+
+TEST_F(RgbMatrixTask, ReportsStats) {
+    run_until_flush();
+    run_until_flush();
+    rgb_matrix_stats_t stats;
+    rgb_matrix_get_stats(&stats);
+    EXPECT_EQ(stats.frames, 2);
+    // Three slices of 16 LEDs from 0 to 2 ms, then one scan for each of the
+    // six blocks they dirtied
+    EXPECT_EQ(stats.frame_time, 2 + 6);
+    EXPECT_EQ(stats.max_frame_time, 2 + 6);
+}
+
+TEST_F(RgbMatrixTask, FlushesOneBlockPerScan) {
+    run_until_flush();
+    for (int scan = 0; scan < 200; scan++) {
+        int block_count = test_block_count;
+        advance_time(1);
+        rgb_matrix_task();
+        EXPECT_LE(test_block_count - block_count, 1);
+    }
+    // 42 LEDs in blocks of 8, all of them sent every frame
+    EXPECT_EQ(test_block_count, test_flush_count * 6);
+}
@@ -0,0 +1,291 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+extern "C" {
+    #include "quantum.h"
+    #include "ws2812.h"
+
+    extern rgblight_config_t rgblight_config;
+
+    void advance_time(uint32_t ms);
+}
+
+// The effects as they were before they went integer only. Each fills
+// expected[] the way the effect fills led[].
+static LED_TYPE expected[RGBLED_NUM];
+
+static void expected_all(uint16_t hue, uint8_t sat, uint8_t val) {
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        sethsv(hue, sat, val, &expected[i]);
+    }
+}
+
+static void reference_breathing(uint8_t pos) {
+    float val = (exp(sin((pos/255.0)*M_PI)) - RGBLIGHT_EFFECT_BREATHE_CENTER/M_E)*(RGBLIGHT_EFFECT_BREATHE_MAX/(M_E-1/M_E));
+    LED_TYPE tmp_led;
+    sethsv(rgblight_config.hue, rgblight_config.sat, val, &tmp_led);
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        expected[i] = tmp_led;
+    }
+}
+
+static void reference_swirl(uint16_t current_hue) {
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        uint16_t hue = (RGBLIGHT_RAINBOW_SWIRL_RANGE / RGBLED_NUM * i + current_hue) % 360;
+        sethsv(hue, rgblight_config.sat, rgblight_config.val, &expected[i]);
+    }
+}
+
+static void reference_snake(uint8_t pos, int8_t increment) {
+    for (uint8_t i = 0; i < RGBLED_NUM; i++) {
+        expected[i] = {};
+        for (uint8_t j = 0; j < RGBLIGHT_EFFECT_SNAKE_LENGTH; j++) {
+            int8_t k = pos + j * increment;
+            if (k < 0) {
+                k = k + RGBLED_NUM;
+            }
+            if (i == k) {
+                sethsv(rgblight_config.hue, rgblight_config.sat, (uint8_t)(rgblight_config.val*(RGBLIGHT_EFFECT_SNAKE_LENGTH-j)/RGBLIGHT_EFFECT_SNAKE_LENGTH), &expected[i]);
+            }
+        }
+    }
+}
+
+class Rgblight : public testing::Test {
+protected:
+    void SetUp() override {
+        rgblight_config.enable = 1;
+        rgblight_config.mode = RGBLIGHT_MODE_zero;
+        rgblight_config.hue = 200;
+        rgblight_config.sat = 230;
+        rgblight_config.val = 250;
+        // a different effect, so this restarts the animation
+        rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+        // start every test from a dark strip that matches led[]
+        memset(led, 0, sizeof(led));
+        ws2812_mock_reset();
+        rgblight_set_full();
+        rgblight_reset_stats();
+        ws2812_mock_calls = 0;
+    }
+
+    // Lets the effect's interval pass and runs it once
+    void step(void (*effect)(uint8_t), uint8_t interval) {
+        advance_time(256);
+        effect(interval);
+    }
+
+    // Checks what the strip shows, which may have come from a partial update
+    void expect_frame(int frame) {
+        for (int i = 0; i < RGBLED_NUM; i++) {
+            const LED_TYPE &actual = ws2812_mock_leds[i];
+            EXPECT_TRUE(actual.r == expected[i].r && actual.g == expected[i].g && actual.b == expected[i].b)
+                << "frame " << frame << ", LED " << i << " is (" << (int)actual.r << ", " << (int)actual.g << ", " << (int)actual.b
+                << "), expected (" << (int)expected[i].r << ", " << (int)expected[i].g << ", " << (int)expected[i].b << ")";
+        }
+    }
+};
+
+TEST_F(Rgblight, BreathingMatchesFloatingPoint) {
+    for (int frame = 0; frame < 600; frame++) {
+        rgblight_config.sat = frame;
+        step(rgblight_effect_breathing, frame % 4);
+        reference_breathing(frame % 256);
+        expect_frame(frame);
+    }
+}
+
+TEST_F(Rgblight, SwirlMatchesModuloHues) {
+    // odd intervals swirl one way, even ones the other
+    uint16_t hue = 0;
+    for (int frame = 0; frame < 800; frame++) {
+        uint8_t interval = frame < 400 ? 1 : 0;
+        step(rgblight_effect_rainbow_swirl, interval);
+        reference_swirl(hue);
+        expect_frame(frame);
+        hue = interval % 2 ? (hue + 1) % 360 : (hue == 0 ? 359 : hue - 1);
+    }
+}
+
+TEST_F(Rgblight, SnakeMatchesFullSearch) {
+    uint8_t pos = 0;
+    for (int frame = 0; frame < 4 * RGBLED_NUM; frame++) {
+        uint8_t interval = frame < 2 * RGBLED_NUM ? 0 : 1;
+        int8_t increment = interval % 2 ? -1 : 1;
+        rgblight_config.val = 255 - frame;
+        step(rgblight_effect_snake, interval);
+        reference_snake(pos, increment);
+        expect_frame(frame);
+        if (increment == 1) {
+            pos = pos == 0 ? RGBLED_NUM - 1 : pos - 1;
+        } else {
+            pos = (pos + 1) % RGBLED_NUM;
+        }
+    }
+}
+
+TEST_F(Rgblight, UnchangedFramesAreSkipped) {
+    rgblight_stats_t stats;
+    rgblight_setrgb(10, 20, 30);
+    rgblight_setrgb(10, 20, 30);
+    rgblight_set();
+
+    EXPECT_EQ(ws2812_mock_calls, 1);
+    rgblight_get_stats(&stats);
+    EXPECT_EQ(stats.frames_sent, 1);
+    EXPECT_EQ(stats.frames_skipped, 2);
+    EXPECT_EQ(stats.leds_sent, RGBLED_NUM);
+}
+
+TEST_F(Rgblight, SetrgbAtSendsUpToThatLed) {
+    rgblight_setrgb(10, 20, 30);
+    rgblight_setrgb_at(1, 2, 3, 4);
+    EXPECT_EQ(ws2812_mock_calls, 2);
+    EXPECT_EQ(ws2812_mock_led_count, 5);
+
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        const LED_TYPE &actual = ws2812_mock_leds[i];
+        if (i == 4) {
+            EXPECT_TRUE(actual.r == 1 && actual.g == 2 && actual.b == 3);
+        } else {
+            EXPECT_TRUE(actual.r == 10 && actual.g == 20 && actual.b == 30) << "LED " << i;
+        }
+    }
+
+    rgblight_setrgb_at(1, 2, 3, 4);
+    EXPECT_EQ(ws2812_mock_calls, 2);
+}
+
+TEST_F(Rgblight, DisabledStripIsBlankedOnce) {
+    rgblight_setrgb(10, 20, 30);
+    rgblight_config.enable = 0;
+    rgblight_set();
+    rgblight_set();
+
+    EXPECT_EQ(ws2812_mock_calls, 2);
+    for (int i = 0; i < RGBLED_NUM; i++) {
+        EXPECT_TRUE(ws2812_mock_leds[i].r == 0 && ws2812_mock_leds[i].g == 0 && ws2812_mock_leds[i].b == 0) << "LED " << i;
+    }
+}
+
+TEST_F(Rgblight, SetFullResendsTheWholeStrip) {
+    rgblight_setrgb(10, 20, 30);
+    rgblight_set_full();
+
+    EXPECT_EQ(ws2812_mock_calls, 2);
+    EXPECT_EQ(ws2812_mock_led_count, RGBLED_NUM);
+}
+
+TEST_F(Rgblight, SlaveFollowsTheMastersPhase) {
+    for (int frame = 0; frame < 10; frame++) {
+        step(rgblight_effect_rainbow_swirl, 1);
+    }
+    advance_time(100);
+    rgblight_syncinfo_t syncinfo;
+    rgblight_get_syncinfo(&syncinfo);
+
+    std::vector<LED_TYPE> master;
+    for (int frame = 0; frame < 20; frame++) {
+        step(rgblight_effect_rainbow_swirl, 1);
+        master.insert(master.end(), led, led + RGBLED_NUM);
+    }
+
+    // the slave has been doing something else until the sync arrives
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+    advance_time(1234);
+    rgblight_update_sync(&syncinfo);
+
+    for (int frame = 0; frame < 20; frame++) {
+        step(rgblight_effect_rainbow_swirl, 1);
+        for (int i = 0; i < RGBLED_NUM; i++) {
+            const LED_TYPE &expected = master[frame * RGBLED_NUM + i];
+            EXPECT_TRUE(led[i].r == expected.r && led[i].g == expected.g && led[i].b == expected.b)
+                << "frame " << frame << ", LED " << i;
+        }
+    }
+}
+
+TEST_F(Rgblight, SyncIsOnlyPendingAfterAChange) {
+    rgblight_syncinfo_t syncinfo;
+    rgblight_get_syncinfo(&syncinfo);
+    EXPECT_FALSE(rgblight_sync_pending());
+
+    // animations stepping on their own need no sync
+    for (int frame = 0; frame < 10; frame++) {
+        step(rgblight_effect_snake, 0);
+    }
+    EXPECT_FALSE(rgblight_sync_pending());
+
+    rgblight_sethsv_noeeprom(10, 20, 30);
+    EXPECT_TRUE(rgblight_sync_pending());
+    rgblight_get_syncinfo(&syncinfo);
+    rgblight_config_t config;
+    config.raw = syncinfo.config;
+    EXPECT_EQ(config.hue, 10);
+    EXPECT_FALSE(rgblight_sync_pending());
+
+    // selecting the same mode again changes nothing
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+    EXPECT_FALSE(rgblight_sync_pending());
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_SNAKE);
+    EXPECT_TRUE(rgblight_sync_pending());
+}
+
+TEST_F(Rgblight, OnlyANewEffectRestartsTheAnimation) {
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_RAINBOW_SWIRL);
+    for (int frame = 0; frame < 10; frame++) {
+        step(rgblight_effect_rainbow_swirl, 1);
+    }
+    rgblight_syncinfo_t before, after;
+    rgblight_get_syncinfo(&before);
+    ASSERT_NE(before.pos, 0);
+
+    // stepping the speed keeps the phase
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_RAINBOW_SWIRL + 2);
+    rgblight_get_syncinfo(&after);
+    EXPECT_EQ(after.pos, before.pos);
+    rgblight_step_noeeprom();
+    rgblight_get_syncinfo(&after);
+    EXPECT_EQ(rgblight_config.mode, RGBLIGHT_MODE_RAINBOW_SWIRL + 3);
+    EXPECT_EQ(after.pos, before.pos);
+
+    // the next effect starts from the beginning
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_SNAKE);
+    rgblight_get_syncinfo(&after);
+    EXPECT_EQ(after.pos, 0);
+}
+
+TEST_F(Rgblight, UpdateSyncLeavesEepromAlone) {
+    uint32_t stored = eeconfig_read_rgblight();
+    rgblight_syncinfo_t syncinfo;
+    rgblight_get_syncinfo(&syncinfo);
+    rgblight_config_t config;
+    config.raw = syncinfo.config;
+    config.hue = (config.hue + 100) % 360;
+    config.mode = RGBLIGHT_MODE_RAINBOW_SWIRL;
+    syncinfo.config = config.raw;
+
+    rgblight_update_sync(&syncinfo);
+    EXPECT_EQ(rgblight_config.hue, config.hue);
+    EXPECT_EQ(rgblight_config.mode, RGBLIGHT_MODE_RAINBOW_SWIRL);
+    EXPECT_EQ(eeconfig_read_rgblight(), stored);
+    EXPECT_FALSE(rgblight_sync_pending());
+}
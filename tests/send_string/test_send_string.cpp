@@ -0,0 +1,110 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include <string>
+#include <vector>
+
+using testing::_;
+using testing::Invoke;
+
+namespace {
+    const char* test_strings[] = {
+        "hello world",
+        "Hello, World!",
+        "aaa abcabc AbCdEf",
+        "The quick brown fox jumps over the lazy dog 0123456789",
+        "zyxwvutsrqponm",
+        "{\"key\": [1, 2, 3]} <a href='#'>~</a>",
+    };
+}
+
+class SendString : public TestFixture {};
+
+TEST_F(SendString, BatchedStringTypesTheSameCharactersAsSendChar) {
+    for (auto str: test_strings) {
+        TestDriver driver;
+        HostDecoder reference;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke(std::ref(reference)));
+        for (const char* c = str; *c; c++) {
+            send_char(*c);
+        }
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        HostDecoder batched;
+        EXPECT_CALL(driver, send_keyboard_mock(_)).WillRepeatedly(Invoke(std::ref(batched)));
+        send_string(str);
+        testing::Mock::VerifyAndClearExpectations(&driver);
+
+        EXPECT_EQ(reference.typed, str);
+        EXPECT_EQ(batched.typed, reference.typed);
+        EXPECT_LT(batched.reports, reference.reports);
+    }
+}
+
+TEST_F(SendString, DistinctLowercaseCharactersShareOneReport) {
+    TestDriver driver;
+    testing::InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    send_string("abca");
+}
+
+TEST_F(SendString, ShiftStateChangeStartsANewReport) {
+    TestDriver driver;
+    testing::InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT, KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_LSFT)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    send_string("ABc");
+}
+
+TEST_F(SendString, TapCodesFlushThePendingBatch) {
+    TestDriver driver;
+    testing::InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_ENTER)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    send_string("ab" SS_TAP(X_ENTER) "c");
+}
+
+TEST_F(SendString, HeldKeysLimitTheBatchSize) {
+    TestDriver driver;
+    press_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    testing::InSequence s;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_B, KC_C, KC_D, KC_E, KC_F)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A, KC_G)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    send_string("bcdefg");
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    release_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    run_one_scan_loop();
+}
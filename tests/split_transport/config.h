@@ -0,0 +1,35 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TESTS_SPLIT_TRANSPORT_CONFIG_H_
+#define TESTS_SPLIT_TRANSPORT_CONFIG_H_
+
+// 13 columns do not fill whole bytes, so rows straddle byte boundaries
+#define MATRIX_ROWS 10
+#define MATRIX_COLS 13
+
+#define RGBLED_NUM 8
+#define RGBLIGHT_ANIMATIONS
+#define RGBLIGHT_SPLIT
+
+#define SPLIT_LAYER_STATE_ENABLE
+#define SPLIT_MODS_ENABLE
+#define SPLIT_LED_STATE_ENABLE
+
+#define SPLIT_LINK_STATS
+#define SPLIT_MATRIX_RETRIES 2
+
+#endif /* TESTS_SPLIT_TRANSPORT_CONFIG_H_ */
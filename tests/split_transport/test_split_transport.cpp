@@ -0,0 +1,548 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include "test_driver.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+
+extern "C" {
+    #include "quantum.h"
+    #include "serial.h"
+    #include "loopback.h"
+
+    extern rgblight_config_t rgblight_config;
+}
+
+#define ROWS_PER_HAND (MATRIX_ROWS / 2)
+#define ALL_COLS ((matrix_row_t)((1UL << MATRIX_COLS) - 1))
+#define PACKED_MATRIX_SIZE ((ROWS_PER_HAND * MATRIX_COLS + 7) / 8)
+#define DELTA_SIZE (1 + (MATRIX_COLS + 7) / 8)
+
+#ifndef SPLIT_MATRIX_DELTAS
+#  define SPLIT_MATRIX_DELTAS 4
+#endif
+
+// Bus time model, in bytes: the transaction id, then the slave's reply and
+// its checksum.
+#define STATUS_BYTES (1 + 1 + 1)
+#define DELTA_BYTES(n) (1 + 1 + (n) * DELTA_SIZE + 1)
+#define MATRIX_BYTES (1 + PACKED_MATRIX_SIZE + 1 + 1)
+// the master's lighting state, only when it changed
+#define SYNC_BYTES (1 + sizeof(rgblight_syncinfo_t) + 1)
+// a channel small enough to go whole
+#define CHANNEL_BYTES(n) (1 + (n) + 1)
+// the slave's ack, then a slice with its pass and offset
+#define SLICE_BYTES (1 + 3 + 1 + 3 + SPLIT_CHANNEL_SLICE + 1)
+
+#ifndef SPLIT_CHANNEL_SLICE
+#  define SPLIT_CHANNEL_SLICE 16
+#endif
+#ifndef SPLIT_CHANNELS
+#  define SPLIT_CHANNELS 6
+#endif
+
+// Channels of a made up feature, with separate buffers on the two halves
+static uint8_t master_state[4], slave_state[4];
+static uint8_t master_report[2], slave_report[2];
+static uint8_t master_blocks[3][12], slave_blocks[3][12];
+static uint8_t master_bulk[100], slave_bulk[100];
+static int state_received, report_received, bulk_received;
+
+static void count_state(void) { state_received++; }
+static void count_report(void) { report_received++; }
+static void count_bulk(void) { bulk_received++; }
+
+static const transport_channel_t master_state_channel = {master_state, sizeof(master_state), TRANSPORT_TO_SLAVE, 1, NULL};
+static const transport_channel_t slave_state_channel = {slave_state, sizeof(slave_state), TRANSPORT_TO_SLAVE, 1, count_state};
+static const transport_channel_t master_report_channel = {master_report, sizeof(master_report), TRANSPORT_TO_MASTER, 1, count_report};
+static const transport_channel_t slave_report_channel = {slave_report, sizeof(slave_report), TRANSPORT_TO_MASTER, 1, NULL};
+static const transport_channel_t master_bulk_channel = {master_bulk, sizeof(master_bulk), TRANSPORT_TO_SLAVE, 10, NULL};
+static const transport_channel_t slave_bulk_channel = {slave_bulk, sizeof(slave_bulk), TRANSPORT_TO_SLAVE, 10, count_bulk};
+// registered from the lowest priority up
+static const transport_channel_t master_block_channels[3] = {
+    {master_blocks[0], 12, TRANSPORT_TO_SLAVE, 9, NULL},
+    {master_blocks[1], 12, TRANSPORT_TO_SLAVE, 5, NULL},
+    {master_blocks[2], 12, TRANSPORT_TO_SLAVE, 1, NULL},
+};
+static const transport_channel_t slave_block_channels[3] = {
+    {slave_blocks[0], 12, TRANSPORT_TO_SLAVE, 9, NULL},
+    {slave_blocks[1], 12, TRANSPORT_TO_SLAVE, 5, NULL},
+    {slave_blocks[2], 12, TRANSPORT_TO_SLAVE, 1, NULL},
+};
+
+class SplitTransport : public testing::Test {
+protected:
+    matrix_row_t slave[ROWS_PER_HAND];
+    matrix_row_t master[ROWS_PER_HAND];
+
+    void SetUp() override {
+        master_transport_master_init();
+        slave_transport_slave_init();
+        serial_mock_reset();
+        state_received = report_received = bulk_received = 0;
+        memset(slave, 0, sizeof(slave));
+        memset(master, 0, sizeof(master));
+        // the first exchange after a reset always fetches the whole matrix,
+        // and sends the master's channels for the slave to take in
+        exchange();
+        slave_transport_slave(slave);
+        serial_mock_reset();
+        master_transport_reset_link_stats();
+    }
+
+    transport_link_stats_t link_stats() {
+        transport_link_stats_t stats;
+        master_transport_get_link_stats(&stats);
+        return stats;
+    }
+
+    // The slave publishes its half, then the master fetches it
+    bool exchange() {
+        slave_transport_slave(slave);
+        return master_transport_master(master);
+    }
+
+    // Both halves register the same channel, each with its own buffer
+    int8_t register_channel(const transport_channel_t *on_master, const transport_channel_t *on_slave) {
+        int8_t id = master_transport_register_channel(on_master);
+        EXPECT_GE(id, 0);
+        EXPECT_EQ(slave_transport_register_channel(on_slave), id);
+        return id;
+    }
+
+    void expect_matrix(const char *what) {
+        for (int row = 0; row < ROWS_PER_HAND; row++) {
+            EXPECT_EQ(master[row], slave[row]) << what << ", row " << row;
+        }
+    }
+};
+
+TEST_F(SplitTransport, EveryKeyArrivesAlone) {
+    for (int row = 0; row < ROWS_PER_HAND; row++) {
+        for (int col = 0; col < MATRIX_COLS; col++) {
+            memset(slave, 0, sizeof(slave));
+            slave[row] = (matrix_row_t)1 << col;
+            ASSERT_TRUE(exchange());
+            expect_matrix("single key");
+        }
+    }
+}
+
+TEST_F(SplitTransport, RandomMatricesRoundTrip) {
+    srand(1);
+    for (int n = 0; n < 1000; n++) {
+        for (int row = 0; row < ROWS_PER_HAND; row++) {
+            slave[row] = rand() & ALL_COLS;
+        }
+        ASSERT_TRUE(exchange());
+        expect_matrix("random matrix");
+    }
+}
+
+TEST_F(SplitTransport, OnlyTheUsedBitsAreSent) {
+    for (int row = 0; row < ROWS_PER_HAND; row++) {
+        slave[row] = ALL_COLS;
+    }
+    ASSERT_TRUE(exchange());
+    expect_matrix("all keys down");
+
+    // more rows changed than the slave keeps deltas for
+    EXPECT_EQ(serial_mock_transactions, 2);
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + MATRIX_BYTES);
+}
+
+TEST_F(SplitTransport, IdleScanOnlyPollsTheSequenceNumber) {
+    slave[1] = 0x1234 & ALL_COLS;
+    ASSERT_TRUE(exchange());
+    serial_mock_reset();
+
+    for (int n = 0; n < 100; n++) {
+        ASSERT_TRUE(exchange());
+    }
+    expect_matrix("idle");
+    EXPECT_EQ(serial_mock_transactions, 100);
+    EXPECT_EQ(serial_mock_bytes, 100 * STATUS_BYTES);
+}
+
+TEST_F(SplitTransport, KeystrokeFetchesOnlyItsRow) {
+    slave[3] = 1 << 11;
+    ASSERT_TRUE(exchange());
+    expect_matrix("press");
+    slave[3] = 0;
+    ASSERT_TRUE(exchange());
+    expect_matrix("release");
+
+    EXPECT_EQ(serial_mock_transactions, 4);
+    EXPECT_EQ(serial_mock_bytes, 2 * (STATUS_BYTES + DELTA_BYTES(1)));
+    printf("bytes per idle scan: %d, per keystroke: %d, sending the matrix every scan: %d\n",
+           STATUS_BYTES, STATUS_BYTES + DELTA_BYTES(1), 1 + PACKED_MATRIX_SIZE + 1);
+}
+
+TEST_F(SplitTransport, ChangesToTheSameRowApplyInOrder) {
+    // the slave scans several times before the master looks
+    slave[2] = 1;
+    slave_transport_slave(slave);
+    slave[2] = 3;
+    slave_transport_slave(slave);
+    slave[4] = 5;
+    slave_transport_slave(slave);
+    slave[2] = 2;
+    ASSERT_TRUE(exchange());
+
+    expect_matrix("four changes");
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + DELTA_BYTES(4));
+}
+
+TEST_F(SplitTransport, TooManyChangesFetchTheMatrix) {
+    for (int n = 0; n <= SPLIT_MATRIX_DELTAS; n++) {
+        slave[0] = n + 1;
+        slave_transport_slave(slave);
+    }
+    ASSERT_TRUE(exchange());
+
+    expect_matrix("missed changes");
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + MATRIX_BYTES);
+}
+
+TEST_F(SplitTransport, NoResponseIsReported) {
+    serial_mock_connected = false;
+    EXPECT_FALSE(exchange());
+}
+
+TEST_F(SplitTransport, ReconnectFetchesTheMatrix) {
+    serial_mock_connected = false;
+    slave[0] = 7;
+    EXPECT_FALSE(exchange());
+
+    // the master may have cleared the other half in the meantime
+    memset(master, 0, sizeof(master));
+    serial_mock_connected = true;
+    serial_mock_reset();
+    ASSERT_TRUE(exchange());
+    expect_matrix("reconnected");
+    // the slave may have restarted, so it gets the lighting state again
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + MATRIX_BYTES + SYNC_BYTES);
+}
+
+TEST_F(SplitTransport, LightingChangesAreSentOnce) {
+    rgblight_config.enable = 1;
+    rgblight_mode_noeeprom(RGBLIGHT_MODE_STATIC_LIGHT);
+    rgblight_sethsv_noeeprom(120, 255, 100);
+    ASSERT_TRUE(exchange());
+    EXPECT_EQ(serial_mock_transactions, 2);
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + SYNC_BYTES);
+    EXPECT_FALSE(rgblight_sync_pending());
+
+    serial_mock_reset();
+    for (int n = 0; n < 10; n++) {
+        ASSERT_TRUE(exchange());
+    }
+    EXPECT_EQ(serial_mock_bytes, 10 * STATUS_BYTES);
+}
+
+TEST_F(SplitTransport, ChannelToTheSlaveIsSentOnce) {
+    int8_t id = register_channel(&master_state_channel, &slave_state_channel);
+    uint8_t state[] = {1, 2, 3, 4};
+    memcpy(master_state, state, sizeof(state));
+    master_transport_channel_changed(id);
+
+    ASSERT_TRUE(exchange());
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + CHANNEL_BYTES(sizeof(state)));
+    EXPECT_FALSE(master_transport_channel_pending(id));
+
+    serial_mock_reset();
+    for (int n = 0; n < 10; n++) {
+        ASSERT_TRUE(exchange());
+    }
+    EXPECT_EQ(serial_mock_bytes, 10 * STATUS_BYTES);
+    EXPECT_EQ(memcmp(slave_state, state, sizeof(state)), 0);
+    EXPECT_EQ(state_received, 1);
+}
+
+TEST_F(SplitTransport, ChannelToTheMasterRidesOnTheSequenceNumber) {
+    int8_t id = register_channel(&master_report_channel, &slave_report_channel);
+    slave_report[0] = 5;
+    slave_report[1] = 6;
+    slave_transport_channel_changed(id);
+    slave[1] = 1;
+
+    ASSERT_TRUE(exchange());
+    expect_matrix("key and report");
+    EXPECT_EQ(master_report[0], 5);
+    EXPECT_EQ(master_report[1], 6);
+    EXPECT_EQ(report_received, 1);
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + DELTA_BYTES(2) + CHANNEL_BYTES(sizeof(slave_report)));
+
+    serial_mock_reset();
+    for (int n = 0; n < 10; n++) {
+        ASSERT_TRUE(exchange());
+    }
+    EXPECT_EQ(serial_mock_bytes, 10 * STATUS_BYTES);
+    EXPECT_EQ(report_received, 1);
+}
+
+TEST_F(SplitTransport, ChannelsGoByPriorityWithinTheBudget) {
+    int8_t ids[3];
+    for (int i = 0; i < 3; i++) {
+        ids[i] = register_channel(&master_block_channels[i], &slave_block_channels[i]);
+        memset(master_blocks[i], i + 1, sizeof(master_blocks[i]));
+        master_transport_channel_changed(ids[i]);
+    }
+
+    // two of them fit one scan, and the matrix still comes first
+    slave[0] = 1;
+    ASSERT_TRUE(exchange());
+    expect_matrix("key with channels");
+    EXPECT_FALSE(master_transport_channel_pending(ids[2]));
+    EXPECT_FALSE(master_transport_channel_pending(ids[1]));
+    EXPECT_TRUE(master_transport_channel_pending(ids[0]));
+
+    ASSERT_TRUE(exchange());
+    EXPECT_FALSE(master_transport_channel_pending(ids[0]));
+    slave_transport_slave(slave);
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(memcmp(slave_blocks[i], master_blocks[i], sizeof(master_blocks[i])), 0) << "channel " << i;
+    }
+}
+
+TEST_F(SplitTransport, LargeChannelsAreSlicedAcrossScans) {
+    int8_t id = register_channel(&master_bulk_channel, &slave_bulk_channel);
+    for (int i = 0; i < (int)sizeof(master_bulk); i++) {
+        master_bulk[i] = i * 7;
+    }
+    master_transport_channel_changed(id);
+
+    int scans = 0;
+    while (master_transport_channel_pending(id) && scans < 100) {
+        serial_mock_reset();
+        ASSERT_TRUE(exchange());
+        EXPECT_LE(serial_mock_bytes, STATUS_BYTES + SLICE_BYTES);
+        scans++;
+    }
+    EXPECT_EQ(memcmp(slave_bulk, master_bulk, sizeof(master_bulk)), 0);
+    EXPECT_EQ(bulk_received, 1);
+    // every slice once, and one more that the slave confirms
+    int slices = (sizeof(master_bulk) + SPLIT_CHANNEL_SLICE - 1) / SPLIT_CHANNEL_SLICE;
+    EXPECT_EQ(scans, slices + 2);
+    printf("%d bytes in %d scans of at most %d bytes\n", (int)sizeof(master_bulk), scans, (int)(STATUS_BYTES + SLICE_BYTES));
+}
+
+TEST_F(SplitTransport, SlowSlaveGetsTheSlicesItMissed) {
+    int8_t id = register_channel(&master_bulk_channel, &slave_bulk_channel);
+    for (int i = 0; i < (int)sizeof(master_bulk); i++) {
+        master_bulk[i] = i + 1;
+    }
+    master_transport_channel_changed(id);
+
+    // the slave only gets around to its channels every third master scan
+    for (int scan = 0; scan < 100 && master_transport_channel_pending(id); scan++) {
+        if (scan % 3 == 0) {
+            slave_transport_slave(slave);
+        }
+        ASSERT_TRUE(master_transport_master(master));
+    }
+    EXPECT_FALSE(master_transport_channel_pending(id));
+    EXPECT_EQ(memcmp(slave_bulk, master_bulk, sizeof(master_bulk)), 0);
+    EXPECT_EQ(bulk_received, 1);
+}
+
+TEST_F(SplitTransport, ChangeDuringAPassStartsOver) {
+    int8_t id = register_channel(&master_bulk_channel, &slave_bulk_channel);
+    memset(master_bulk, 1, sizeof(master_bulk));
+    master_transport_channel_changed(id);
+    for (int n = 0; n < 3; n++) {
+        ASSERT_TRUE(exchange());
+    }
+
+    memset(master_bulk, 2, sizeof(master_bulk));
+    master_transport_channel_changed(id);
+    for (int n = 0; n < 100 && master_transport_channel_pending(id); n++) {
+        ASSERT_TRUE(exchange());
+    }
+    // the slave never saw a mix of both
+    EXPECT_EQ(bulk_received, 1);
+    EXPECT_EQ(memcmp(slave_bulk, master_bulk, sizeof(master_bulk)), 0);
+}
+
+TEST_F(SplitTransport, ChannelsAreSentAgainAfterAReconnect) {
+    int8_t id = register_channel(&master_state_channel, &slave_state_channel);
+    memset(master_state, 9, sizeof(master_state));
+    master_transport_channel_changed(id);
+    ASSERT_TRUE(exchange());
+    slave_transport_slave(slave);
+    EXPECT_EQ(state_received, 1);
+
+    serial_mock_connected = false;
+    EXPECT_FALSE(exchange());
+    EXPECT_TRUE(master_transport_channel_pending(id));
+    serial_mock_connected = true;
+    ASSERT_TRUE(exchange());
+    slave_transport_slave(slave);
+    EXPECT_EQ(state_received, 2);
+}
+
+TEST_F(SplitTransport, ChannelsThatDoNotFitAreRejected) {
+    // only the master can send in slices
+    static const transport_channel_t large_report = {master_bulk, sizeof(master_bulk), TRANSPORT_TO_MASTER, 1, NULL};
+    EXPECT_EQ(master_transport_register_channel(&large_report), -1);
+
+    // the lighting state already has one
+    int registered = 0;
+    while (master_transport_register_channel(&master_state_channel) >= 0) {
+        registered++;
+    }
+    EXPECT_EQ(registered, SPLIT_CHANNELS - 1);
+}
+
+TEST_F(SplitTransport, LayerStateIsMirroredOnlyWhenItChanges) {
+    master_split_state_init();
+    slave_split_state_init();
+    for (int n = 0; n < 10; n++) {
+        master_split_state_update();
+        ASSERT_TRUE(exchange());
+    }
+    EXPECT_EQ(serial_mock_bytes, 10 * STATUS_BYTES);
+
+    serial_mock_reset();
+    layer_state = 0x6;
+    default_layer_state = 0x1;
+    master_split_state_update();
+    ASSERT_TRUE(exchange());
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + CHANNEL_BYTES(8));
+
+    // both halves share the globals here, so make the slave's differ
+    layer_state = 0;
+    default_layer_state = 0;
+    slave_transport_slave(slave);
+    EXPECT_EQ(layer_state, 0x6);
+    EXPECT_EQ(default_layer_state, 0x1);
+
+    serial_mock_reset();
+    for (int n = 0; n < 10; n++) {
+        master_split_state_update();
+        ASSERT_TRUE(exchange());
+    }
+    EXPECT_EQ(serial_mock_bytes, 10 * STATUS_BYTES);
+    layer_state = 0;
+    default_layer_state = 0;
+}
+
+TEST_F(SplitTransport, ModsAndHostLedsAreMirrored) {
+    TestDriver driver;
+    master_split_state_init();
+    slave_split_state_init();
+
+    set_mods(MOD_BIT(KC_LSFT));
+    driver.set_leds(1 << USB_LED_CAPS_LOCK);
+    master_split_state_update();
+    ASSERT_TRUE(exchange());
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + 2 * CHANNEL_BYTES(1));
+
+    clear_mods();
+    EXPECT_EQ(slave_split_state_host_leds(), 0);
+    slave_transport_slave(slave);
+    EXPECT_EQ(get_mods(), MOD_BIT(KC_LSFT));
+    EXPECT_EQ(slave_split_state_host_leds(), 1 << USB_LED_CAPS_LOCK);
+
+    // a modifier alone does not resend the LEDs
+    serial_mock_reset();
+    set_mods(0);
+    master_split_state_update();
+    ASSERT_TRUE(exchange());
+    EXPECT_EQ(serial_mock_bytes, STATUS_BYTES + CHANNEL_BYTES(1));
+    slave_transport_slave(slave);
+    EXPECT_EQ(get_mods(), 0);
+}
+
+TEST_F(SplitTransport, LinkStatsCountTransactions) {
+    for (int n = 0; n < 5; n++) {
+        ASSERT_TRUE(exchange());
+    }
+    serial_mock_connected = false;
+    EXPECT_FALSE(exchange());
+    EXPECT_FALSE(exchange());
+
+    transport_link_stats_t stats = link_stats();
+    EXPECT_EQ(stats.transactions, serial_mock_transactions);
+    // the link was up before the first failure, so that scan retried
+    EXPECT_EQ(stats.failures, 2 + SPLIT_MATRIX_RETRIES);
+    EXPECT_EQ(stats.retries, SPLIT_MATRIX_RETRIES);
+    EXPECT_EQ(stats.recovered, 0);
+    EXPECT_EQ(serial_mock_transactions, 5 + 2 + SPLIT_MATRIX_RETRIES);
+}
+
+TEST_F(SplitTransport, GlitchIsRetriedInTheSameScan) {
+    slave[1] = 0x15;
+    serial_mock_errors = 1;
+    ASSERT_TRUE(exchange());
+    expect_matrix("retried");
+
+    transport_link_stats_t stats = link_stats();
+    EXPECT_EQ(stats.failures, 1);
+    EXPECT_EQ(stats.retries, 1);
+    EXPECT_EQ(stats.recovered, 1);
+    EXPECT_EQ(stats.parity_errors, 1);
+    // the scan went on with the deltas
+    EXPECT_EQ(serial_mock_bytes, 2 * STATUS_BYTES + DELTA_BYTES(1));
+}
+
+TEST_F(SplitTransport, RetriesAreLimited) {
+    serial_mock_errors = SPLIT_MATRIX_RETRIES + 1;
+    EXPECT_FALSE(exchange());
+    transport_link_stats_t stats = link_stats();
+    EXPECT_EQ(stats.retries, SPLIT_MATRIX_RETRIES);
+    EXPECT_EQ(stats.recovered, 0);
+
+    // without a link the next scan does not retry, and then fetches the
+    // whole matrix
+    serial_mock_errors = 1;
+    EXPECT_FALSE(exchange());
+    ASSERT_TRUE(exchange());
+    stats = link_stats();
+    EXPECT_EQ(stats.retries, SPLIT_MATRIX_RETRIES);
+    EXPECT_EQ(stats.failures, SPLIT_MATRIX_RETRIES + 2);
+}
+
+TEST_F(SplitTransport, LatencyPercentiles) {
+    transport_link_stats_t stats = link_stats();
+    EXPECT_EQ(master_transport_link_latency(&stats, 50), 0);
+
+    for (int n = 0; n < 90; n++) {
+        ASSERT_TRUE(exchange());
+    }
+    serial_mock_delay = 2;
+    for (int n = 0; n < 10; n++) {
+        ASSERT_TRUE(exchange());
+    }
+
+    stats = link_stats();
+    EXPECT_EQ(stats.latency[0], 90);
+    EXPECT_EQ(stats.latency[TRANSPORT_LATENCY_BUCKETS], 10);
+    EXPECT_EQ(master_transport_link_latency(&stats, 50), TRANSPORT_LATENCY_STEP);
+    EXPECT_EQ(master_transport_link_latency(&stats, 90), TRANSPORT_LATENCY_STEP);
+    EXPECT_EQ(master_transport_link_latency(&stats, 99), UINT16_MAX);
+}
+
+TEST_F(SplitTransport, LatencyPercentilesAfterDaysOfScans) {
+    transport_link_stats_t stats = {};
+    stats.latency[0] = UINT32_MAX;
+    stats.latency[2] = UINT32_MAX / 4;
+    stats.latency[TRANSPORT_LATENCY_BUCKETS] = UINT32_MAX / 100;
+    EXPECT_EQ(master_transport_link_latency(&stats, 50), TRANSPORT_LATENCY_STEP);
+    EXPECT_EQ(master_transport_link_latency(&stats, 90), 3 * TRANSPORT_LATENCY_STEP);
+    EXPECT_EQ(master_transport_link_latency(&stats, 100), UINT16_MAX);
+}
@@ -0,0 +1,47 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// The dances are spread out over several bytes of the active set
+#define TD_FIRST 0
+#define TD_LAYER 9
+#define TD_LAST  60
+// the highest dance there can be, for the benchmark
+#define TD_MANY  255
+
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        // 0           1             2            3      4      5      6      7      8      9
+        {TD(TD_FIRST), TD(TD_LAST),  TD(TD_LAYER), KC_C,  KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {TD(TD_MANY),  KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+    [1] = {
+        {KC_TRNS,      KC_TRNS,      KC_TRNS,      KC_D,  KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_TRNS,      KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+        {KC_NO,        KC_NO,        KC_NO,        KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO, KC_NO},
+    },
+};
+
+qk_tap_dance_action_t tap_dance_actions[] = {
+    [TD_FIRST] = ACTION_TAP_DANCE_DOUBLE(KC_A, KC_B),
+    [TD_LAYER] = ACTION_TAP_DANCE_DUAL_ROLE(KC_E, 1),
+    [TD_LAST]  = ACTION_TAP_DANCE_DOUBLE(KC_X, KC_Y),
+    [TD_MANY]  = ACTION_TAP_DANCE_DOUBLE(KC_F, KC_G),
+};
@@ -0,0 +1,163 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "test_common.hpp"
+#include "action_tapping.h"
+#include <chrono>
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+// What the scan did before the active set: every dance up to the highest
+// one used is looked at, in progress or not. Returns how many are due.
+static int scan_every_dance(int16_t highest_td) {
+    int due = 0;
+    for (int16_t i = 0; i <= highest_td; i++) {
+        qk_tap_dance_action_t *action = &tap_dance_actions[i];
+        uint16_t term = action->custom_tapping_term > 0 ? action->custom_tapping_term : TAPPING_TERM;
+        if (action->state.count && timer_elapsed(action->state.timer) > term) {
+            due++;
+        }
+    }
+    return due;
+}
+
+class TapDance : public TestFixture {
+protected:
+    void tap_key(uint8_t col, uint8_t row) {
+        press_key(col, row);
+        run_one_scan_loop();
+        release_key(col, row);
+        run_one_scan_loop();
+    }
+};
+
+TEST_F(TapDance, SingleTapIsSentAfterTheTappingTerm) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(0);
+    tap_key(0, 0);
+    idle_for(TAPPING_TERM - 10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    idle_for(20);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDance, DoubleTapSendsTheSecondKey) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_Y)));
+    tap_key(1, 0);
+    tap_key(1, 0);
+    idle_for(TAPPING_TERM + 10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDance, AnotherKeyFinishesTheDanceImmediately) {
+    TestDriver driver;
+    InSequence s;
+    tap_key(1, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_C)));
+    press_key(3, 0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(3, 0);
+    run_one_scan_loop();
+}
+
+TEST_F(TapDance, DancesInDifferentBytesAreInterrupted) {
+    TestDriver driver;
+    InSequence s;
+    tap_key(0, 0);
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_A)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    tap_key(1, 0);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_X)));
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport())).Times(AnyNumber());
+    idle_for(TAPPING_TERM + 10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TapDance, DoubleTapOfDualRoleMovesToTheLayer) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    tap_key(2, 0);
+    press_key(2, 0);
+    run_one_scan_loop();
+    idle_for(TAPPING_TERM + 10);
+    release_key(2, 0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport(KC_D)));
+    press_key(3, 0);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_CALL(driver, send_keyboard_mock(KeyboardReport()));
+    release_key(3, 0);
+    run_one_scan_loop();
+}
+
+// Not a pass/fail check, just prints what a scan costs with 256 dances
+// defined, idle and with one dance in progress, against the old full loop
+TEST_F(TapDance, BenchmarkScanWithManyDances) {
+    TestDriver driver;
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+    // makes the last dance the highest one used
+    tap_key(0, 1);
+    idle_for(TAPPING_TERM + 10);
+
+    // TD_MANY in keymap.c
+    const int16_t highest_td = 255;
+    const int scans = 100000;
+    int due = 0;
+    for (int dancing = 0; dancing <= 1; dancing++) {
+        if (dancing) {
+            tap_key(0, 0);
+        }
+        // the clock stands still, so nothing finishes while this runs
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < scans; i++) {
+            matrix_scan_tap_dance();
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (int i = 0; i < scans; i++) {
+            due += scan_every_dance(highest_td);
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double active = std::chrono::duration<double, std::nano>(middle - start).count() / scans;
+        double every = std::chrono::duration<double, std::nano>(end - middle).count() / scans;
+        printf("%s: active set %.1f ns/scan, every dance %.1f ns/scan\n", dancing ? "one dance" : "idle", active, every);
+    }
+    EXPECT_EQ(due, 0);
+
+    idle_for(TAPPING_TERM + 10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
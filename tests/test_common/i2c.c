@@ -0,0 +1,107 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "i2c.h"
+#include "split_common/split_flags.h"
+
+uint32_t i2c_mock_transactions;
+uint32_t i2c_mock_bytes;
+bool i2c_mock_connected = true;
+
+volatile uint8_t i2c_slave_buffer[SLAVE_BUFFER_SIZE];
+volatile uint8_t i2c_slave_written[(SLAVE_BUFFER_SIZE + 7) / 8];
+
+static uint8_t slave_buffer_pos;
+static bool slave_has_register_set;
+
+void i2c_mock_reset(void) {
+    i2c_mock_transactions = 0;
+    i2c_mock_bytes = 0;
+    i2c_mock_connected = true;
+}
+
+void i2c_master_init(void) {
+}
+
+void i2c_slave_init(uint8_t address) {
+}
+
+uint8_t i2c_master_start(uint8_t address) {
+    i2c_mock_transactions++;
+    i2c_mock_bytes++;
+    if (!i2c_mock_connected) {
+        return 1;
+    }
+    // a write starts with the register, a read carries on where the last
+    // transaction left off
+    if ((address & 1) == I2C_WRITE) {
+        slave_has_register_set = false;
+    }
+    return 0;
+}
+
+void i2c_master_stop(void) {
+}
+
+uint8_t i2c_master_write(uint8_t data) {
+    i2c_mock_bytes++;
+    if (!i2c_mock_connected) {
+        return 1;
+    }
+    if (!slave_has_register_set) {
+        if (data >= SLAVE_BUFFER_SIZE) {
+            slave_buffer_pos = 0;
+            return 1;
+        }
+        slave_buffer_pos = data;
+        slave_has_register_set = true;
+        return 0;
+    }
+
+    i2c_slave_buffer[slave_buffer_pos] = data;
+    i2c_slave_written[slave_buffer_pos >> 3] |= 1 << (slave_buffer_pos & 7);
+    if (slave_buffer_pos == I2C_BACKLIT_START) {
+        BACKLIT_DIRTY = true;
+    } else if (slave_buffer_pos == I2C_RGB_START + I2C_RGB_SIZE - 1) {
+        RGB_DIRTY = true;
+    }
+    slave_buffer_pos = (slave_buffer_pos + 1) % SLAVE_BUFFER_SIZE;
+    return 0;
+}
+
+uint8_t i2c_master_write_data(void *const TXdata, uint8_t dataLen) {
+    uint8_t *data = (uint8_t *)TXdata;
+    for (uint8_t i = 0; i < dataLen; i++) {
+        if (i2c_master_write(data[i])) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+uint8_t i2c_master_read(int ack) {
+    i2c_mock_bytes++;
+    if (!i2c_mock_connected) {
+        return 0xFF;
+    }
+    uint8_t data = i2c_slave_buffer[slave_buffer_pos];
+    slave_buffer_pos = (slave_buffer_pos + 1) % SLAVE_BUFFER_SIZE;
+    return data;
+}
+
+void i2c_reset_state(void) {
+}
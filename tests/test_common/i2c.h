@@ -0,0 +1,32 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "split_common/i2c.h"
+
+// Stands in for the slave's TWI interrupt: the master's writes and reads go
+// straight to i2c_slave_buffer, the way split_common/i2c.c handles them, and
+// the bytes a real bus would clock out are counted, address bytes included.
+extern uint32_t i2c_mock_transactions;
+extern uint32_t i2c_mock_bytes;
+// the slave answers its address
+extern bool i2c_mock_connected;
+
+void i2c_mock_reset(void);
@@ -0,0 +1,82 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "i2c_master.h"
+#include <string.h>
+
+#define I2C_MOCK_PAGE_REGISTER 0xFD
+#define I2C_MOCK_PAGES 16
+
+uint32_t i2c_mock_transfers = 0;
+uint32_t i2c_mock_bytes = 0;
+int16_t i2c_mock_failing_register = -1;
+
+static uint8_t registers[128][I2C_MOCK_PAGES][256];
+static uint8_t pages[128];
+
+void i2c_mock_reset(void) {
+    memset(registers, 0, sizeof(registers));
+    memset(pages, 0, sizeof(pages));
+    i2c_mock_transfers = 0;
+    i2c_mock_bytes = 0;
+    i2c_mock_failing_register = -1;
+}
+
+uint8_t i2c_mock_register(uint8_t address, uint8_t page, uint8_t reg) {
+    return registers[address & 0x7F][page % I2C_MOCK_PAGES][reg];
+}
+
+void i2c_init(void) {
+}
+
+i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    uint8_t address = (devaddr >> 1) & 0x7F;
+
+    if (regaddr == i2c_mock_failing_register) {
+        return I2C_STATUS_ERROR;
+    }
+    i2c_mock_transfers++;
+    i2c_mock_bytes += length + 1;
+    for (uint16_t i = 0; i < length; i++) {
+        uint8_t reg = regaddr + i;
+        if (reg == I2C_MOCK_PAGE_REGISTER) {
+            pages[address] = data[i] % I2C_MOCK_PAGES;
+        }
+        registers[address][pages[address]][reg] = data[i];
+    }
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_transmit(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    if (length == 0) {
+        i2c_mock_transfers++;
+        return I2C_STATUS_SUCCESS;
+    }
+    return i2c_writeReg(address, data[0], data + 1, length - 1, timeout);
+}
+
+i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    memset(data, 0, length);
+    return I2C_STATUS_SUCCESS;
+}
+
+i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    uint8_t address = (devaddr >> 1) & 0x7F;
+    for (uint16_t i = 0; i < length; i++) {
+        data[i] = registers[address][pages[address]][(uint8_t)(regaddr + i)];
+    }
+    return I2C_STATUS_SUCCESS;
+}
@@ -15,6 +15,9 @@
  */
 
  #include "keyboard_report_util.hpp"
+ extern "C" {
+ #include "quantum.h"
+ }
  #include <vector>
  #include <algorithm>
  using namespace testing;
@@ -37,6 +40,16 @@
         std::sort(result.begin(), result.end());
         return result;
      }
+
+     char to_ascii(uint8_t key, bool shifted) {
+        for (int c=0x20; c<0x7F; c++) {
+            if (pgm_read_byte(&ascii_to_keycode_lut[c]) == key &&
+                (bool)pgm_read_byte(&ascii_to_shift_lut[c]) == shifted) {
+                return c;
+            }
+        }
+        return '?';
+     }
  }
 
 bool operator==(const report_keyboard_t& lhs, const report_keyboard_t& rhs) {
@@ -79,4 +92,19 @@ void KeyboardReportMatcher::DescribeTo(::std::ostream* os) const {
 
 void KeyboardReportMatcher::DescribeNegationTo(::std::ostream* os) const {
     *os << "is not equal to " << m_report;
-}
\ No newline at end of file
+}
+
+void HostDecoder::operator()(report_keyboard_t& report) {
+    reports++;
+    bool shifted = report.mods & (MOD_BIT(KC_LSFT) | MOD_BIT(KC_RSFT));
+    std::vector<uint8_t> keys;
+    for (size_t i=0; i<KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t key = report.keys[i];
+        if (!key) continue;
+        keys.push_back(key);
+        if (std::find(m_pressed.begin(), m_pressed.end(), key) == m_pressed.end()) {
+            typed += to_ascii(key, shifted);
+        }
+    }
+    m_pressed = keys;
+}
@@ -18,6 +18,8 @@
 #include "report.h"
 #include <ostream>
 #include "gmock/gmock.h"
+#include <string>
+#include <vector>
 
 bool operator==(const report_keyboard_t& lhs, const report_keyboard_t& rhs);
 std::ostream& operator<<(std::ostream& stream, const report_keyboard_t& value);
@@ -36,4 +38,17 @@ private:
 template<typename... Ts>
 inline testing::Matcher<report_keyboard_t&> KeyboardReport(Ts... keys) {
     return testing::MakeMatcher(new KeyboardReportMatcher(std::vector<uint8_t>({keys...})));
-}
\ No newline at end of file
+}
+
+// Replays the reports the way a host would, turning every newly pressed key
+// into the character it types with the current shift state. Pass it to
+// Invoke() on send_keyboard_mock.
+class HostDecoder {
+public:
+    void operator()(report_keyboard_t& report);
+
+    std::string typed;
+    unsigned reports = 0;
+private:
+    std::vector<uint8_t> m_pressed;
+};
@@ -0,0 +1,43 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "split_common/transport.h"
+#include "split_common/split_state.h"
+
+/* The transport and the state mirroring are built twice, once for each half,
+ * and the serial or I2C mock carries the data between the two, so both ends
+ * of the link run with their own state. Call the master's side with master_
+ * and the slave's with slave_.
+ */
+#define LOOPBACK_DECLARE(half) \
+    void half##_transport_master_init(void); \
+    void half##_transport_slave_init(void); \
+    bool half##_transport_master(matrix_row_t matrix[]); \
+    void half##_transport_slave(matrix_row_t matrix[]); \
+    int8_t half##_transport_register_channel(const transport_channel_t *channel); \
+    void half##_transport_channel_changed(int8_t id); \
+    bool half##_transport_channel_pending(int8_t id); \
+    void half##_split_state_init(void); \
+    void half##_split_state_update(void); \
+    uint8_t half##_split_state_host_leds(void); \
+    void half##_transport_get_link_stats(transport_link_stats_t *stats); \
+    void half##_transport_reset_link_stats(void); \
+    uint16_t half##_transport_link_latency(const transport_link_stats_t *stats, uint8_t percent);
+
+LOOPBACK_DECLARE(master)
+LOOPBACK_DECLARE(slave)
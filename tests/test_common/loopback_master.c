@@ -0,0 +1,40 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The master's copy of the transport and the state mirroring, with its own state
+#define transport_master_init      master_transport_master_init
+#define transport_slave_init       master_transport_slave_init
+#define transport_master           master_transport_master
+#define transport_slave            master_transport_slave
+#define transport_register_channel master_transport_register_channel
+#define transport_channel_changed  master_transport_channel_changed
+#define transport_channel_pending  master_transport_channel_pending
+#define transport_get_link_stats   master_transport_get_link_stats
+#define transport_reset_link_stats master_transport_reset_link_stats
+#define transport_link_latency     master_transport_link_latency
+#define transport_print_link_stats master_transport_print_link_stats
+#define split_state_init           master_split_state_init
+#define split_state_update         master_split_state_update
+#define split_state_host_leds      master_split_state_host_leds
+// Over I2C the slave's flags are set by the bus, so the master has its own
+#define RGB_DIRTY                  master_RGB_DIRTY
+#define BACKLIT_DIRTY              master_BACKLIT_DIRTY
+
+#include "split_common/transport.c"
+#include "split_common/split_state.c"
+
+volatile bool master_RGB_DIRTY = false;
+volatile bool master_BACKLIT_DIRTY = false;
@@ -0,0 +1,34 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The slave's copy of the transport and the state mirroring, with its own state
+#define transport_master_init      slave_transport_master_init
+#define transport_slave_init       slave_transport_slave_init
+#define transport_master           slave_transport_master
+#define transport_slave            slave_transport_slave
+#define transport_register_channel slave_transport_register_channel
+#define transport_channel_changed  slave_transport_channel_changed
+#define transport_channel_pending  slave_transport_channel_pending
+#define transport_get_link_stats   slave_transport_get_link_stats
+#define transport_reset_link_stats slave_transport_reset_link_stats
+#define transport_link_latency     slave_transport_link_latency
+#define transport_print_link_stats slave_transport_print_link_stats
+#define split_state_init           slave_split_state_init
+#define split_state_update         slave_split_state_update
+#define split_state_host_leds      slave_split_state_host_leds
+
+#include "split_common/transport.c"
+#include "split_common/split_state.c"
@@ -0,0 +1,118 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "serial.h"
+
+void advance_time(uint32_t ms);
+
+uint32_t serial_mock_transactions;
+uint32_t serial_mock_bytes;
+bool serial_mock_connected = true;
+uint8_t serial_mock_errors;
+uint32_t serial_mock_delay;
+static int serial_mock_parity_errors;
+
+static SSTD_t *serial_mock_initiator;
+static SSTD_t *serial_mock_target;
+
+void serial_mock_reset(void) {
+    serial_mock_transactions = 0;
+    serial_mock_bytes = 0;
+    serial_mock_connected = true;
+    serial_mock_errors = 0;
+    serial_mock_delay = 0;
+    serial_mock_parity_errors = 0;
+}
+
+void soft_serial_initiator_init(SSTD_t *sstd_table, int sstd_table_size) {
+    serial_mock_initiator = sstd_table;
+}
+
+void soft_serial_target_init(SSTD_t *sstd_table, int sstd_table_size) {
+    serial_mock_target = sstd_table;
+}
+
+// Copies a packet from one end's buffer to the other's, unless both ends
+// share the table
+static void serial_mock_copy(uint8_t *to, const uint8_t *from, uint8_t size) {
+    if (to != from) {
+        memcpy(to, from, size);
+    }
+}
+
+#ifndef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_transaction(void) {
+    SSTD_t *trans = serial_mock_initiator;
+    SSTD_t *target = serial_mock_target;
+#else
+int soft_serial_transaction(int sstd_index) {
+    SSTD_t *trans = &serial_mock_initiator[sstd_index];
+    SSTD_t *target = &serial_mock_target[sstd_index];
+#endif
+    serial_mock_transactions++;
+    // the handshake, or the transaction id
+    serial_mock_bytes++;
+    advance_time(serial_mock_delay);
+
+    if (!serial_mock_connected) {
+        *trans->status = TRANSACTION_NO_RESPONSE;
+        return TRANSACTION_NO_RESPONSE;
+    }
+
+    // a mismatch is what a real link sees as a broken packet
+    if (trans->target2initiator_buffer_size != target->target2initiator_buffer_size ||
+        trans->initiator2target_buffer_size != target->initiator2target_buffer_size) {
+        *trans->status = TRANSACTION_DATA_ERROR;
+        return TRANSACTION_DATA_ERROR;
+    }
+
+    // the target answers first, and each packet is followed by its checksum
+    if (trans->target2initiator_buffer_size > 0) {
+        if (serial_mock_errors > 0) {
+            serial_mock_errors--;
+            serial_mock_parity_errors++;
+            serial_mock_bytes += trans->target2initiator_buffer_size + 1;
+            *trans->status = TRANSACTION_DATA_ERROR;
+            return TRANSACTION_DATA_ERROR;
+        }
+        serial_mock_copy(trans->target2initiator_buffer, target->target2initiator_buffer, trans->target2initiator_buffer_size);
+        serial_mock_bytes += trans->target2initiator_buffer_size + 1;
+    }
+    if (trans->initiator2target_buffer_size > 0) {
+        serial_mock_copy(target->initiator2target_buffer, trans->initiator2target_buffer, trans->initiator2target_buffer_size);
+        serial_mock_bytes += trans->initiator2target_buffer_size + 1;
+    }
+
+    *trans->status = TRANSACTION_END;
+    *target->status = TRANSACTION_ACCEPTED;
+    return TRANSACTION_END;
+}
+
+#ifdef SERIAL_USE_MULTI_TRANSACTION
+int soft_serial_get_and_clean_status(int sstd_index) {
+    SSTD_t *trans = &serial_mock_target[sstd_index];
+    int retval = *trans->status;
+    *trans->status = 0;
+    return retval;
+}
+#endif
+
+int soft_serial_get_and_clean_parity_errors(void) {
+    int retval = serial_mock_parity_errors;
+    serial_mock_parity_errors = 0;
+    return retval;
+}
@@ -0,0 +1,33 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include "split_common/serial.h"
+
+// Both halves live in the same process. When they have their own tables a
+// transaction copies the packets across, and either way it accounts for the
+// bytes a real link would have clocked out.
+extern uint32_t serial_mock_transactions;
+extern uint32_t serial_mock_bytes;
+extern bool serial_mock_connected;
+// the next this many transactions get a parity error in the target's reply
+extern uint8_t serial_mock_errors;
+// ms each transaction takes
+extern uint32_t serial_mock_delay;
+
+void serial_mock_reset(void);
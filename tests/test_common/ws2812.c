@@ -0,0 +1,41 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ws2812.h"
+#include <string.h>
+
+uint32_t ws2812_mock_calls;
+uint16_t ws2812_mock_led_count;
+LED_TYPE ws2812_mock_leds[WS2812_MOCK_MAX_LEDS];
+
+void ws2812_mock_reset(void) {
+    ws2812_mock_calls = 0;
+    ws2812_mock_led_count = 0;
+    memset(ws2812_mock_leds, 0, sizeof(ws2812_mock_leds));
+}
+
+void ws2812_setleds(LED_TYPE *ledarray, uint16_t number_of_leds) {
+    ws2812_mock_calls++;
+    ws2812_mock_led_count = number_of_leds;
+    if (number_of_leds > WS2812_MOCK_MAX_LEDS) {
+        number_of_leds = WS2812_MOCK_MAX_LEDS;
+    }
+    memcpy(ws2812_mock_leds, ledarray, number_of_leds * sizeof(LED_TYPE));
+}
+
+void ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t number_of_leds) {
+    ws2812_setleds(ledarray, number_of_leds);
+}
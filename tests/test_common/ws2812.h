@@ -0,0 +1,37 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIGHT_WS2812_H_
+#define LIGHT_WS2812_H_
+
+#include <stdint.h>
+#include "rgblight_types.h"
+
+// Native stand-in for the WS2812 driver, picked up by tests that enable
+// rgblight. Every call is counted and the LEDs it sent are kept.
+
+void ws2812_setleds     (LED_TYPE *ledarray, uint16_t number_of_leds);
+void ws2812_setleds_rgbw(LED_TYPE *ledarray, uint16_t number_of_leds);
+
+#define WS2812_MOCK_MAX_LEDS 64
+
+extern uint32_t ws2812_mock_calls;
+extern uint16_t ws2812_mock_led_count;
+extern LED_TYPE ws2812_mock_leds[WS2812_MOCK_MAX_LEDS];
+
+void ws2812_mock_reset(void);
+
+#endif /* LIGHT_WS2812_H_ */
@@ -0,0 +1,176 @@
+/* Copyright 2026 agent
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+#include <vector>
+
+extern "C" {
+    #include "ws2812_encode.h"
+    #include "rgblight_types.h"
+}
+
+// Unpacks the SPI stream into single bits, MSB first
+static std::vector<int> spi_bits(const uint8_t *buffer, uint16_t length) {
+    std::vector<int> bits;
+    for (uint16_t i = 0; i < length; i++) {
+        for (int bit = 7; bit >= 0; bit--) {
+            bits.push_back((buffer[i] >> bit) & 1);
+        }
+    }
+    return bits;
+}
+
+// Reads the data back the way a WS2812 does: every bit starts with a rising
+// edge, and a high time of two SPI bits or more is a one
+static std::vector<uint8_t> decode(const std::vector<int> &bits, size_t data_bits) {
+    std::vector<uint8_t> data;
+    size_t pos = 0;
+    for (size_t n = 0; n < data_bits; n++) {
+        EXPECT_EQ(bits[pos], 1) << "bit " << n << " does not start high";
+        size_t high = 0;
+        while (pos < bits.size() && bits[pos] == 1) {
+            high++;
+            pos++;
+        }
+        size_t low = 0;
+        while (pos < bits.size() && bits[pos] == 0 && low < 2 - (high >= 2)) {
+            low++;
+            pos++;
+        }
+        EXPECT_EQ(high + low, 3u) << "bit " << n << " is not three SPI bits long";
+        if (n % 8 == 0) {
+            data.push_back(0);
+        }
+        data.back() = (data.back() << 1) | (high >= 2);
+    }
+    return data;
+}
+
+TEST(Ws2812Encode, ZeroAndOneBytes) {
+    uint8_t data[] = {0x00, 0xFF};
+    uint8_t buffer[WS2812_ENCODED_SIZE(2)];
+    uint16_t length = ws2812_encode(data, 2, buffer);
+
+    ASSERT_EQ(length, 6 + WS2812_RESET_BYTES);
+    // 100 100 100 100 100 100 100 100
+    EXPECT_EQ(buffer[0], 0x92);
+    EXPECT_EQ(buffer[1], 0x49);
+    EXPECT_EQ(buffer[2], 0x24);
+    // 110 110 110 110 110 110 110 110
+    EXPECT_EQ(buffer[3], 0xDB);
+    EXPECT_EQ(buffer[4], 0x6D);
+    EXPECT_EQ(buffer[5], 0xB6);
+}
+
+TEST(Ws2812Encode, MixedByte) {
+    uint8_t data = 0xA5;
+    uint8_t buffer[WS2812_ENCODED_SIZE(1)];
+    ws2812_encode(&data, 1, buffer);
+    // 110 100 110 100 100 110 100 110
+    EXPECT_EQ(buffer[0], 0xD3);
+    EXPECT_EQ(buffer[1], 0x49);
+    EXPECT_EQ(buffer[2], 0xA6);
+}
+
+TEST(Ws2812Encode, EveryByteValueDecodes) {
+    uint8_t data[256];
+    for (int i = 0; i < 256; i++) {
+        data[i] = i;
+    }
+    std::vector<uint8_t> buffer(WS2812_ENCODED_SIZE(256));
+    uint16_t length = ws2812_encode(data, 256, buffer.data());
+
+    std::vector<int> bits = spi_bits(buffer.data(), length);
+    std::vector<uint8_t> decoded = decode(bits, 256 * 8);
+    for (int i = 0; i < 256; i++) {
+        EXPECT_EQ(decoded[i], i);
+    }
+}
+
+TEST(Ws2812Encode, LedsGoOutGreenRedBlueThenReset) {
+    LED_TYPE leds[2] = {};
+    leds[0].r = 0x11; leds[0].g = 0x22; leds[0].b = 0x33;
+    leds[1].r = 0x44; leds[1].g = 0x55; leds[1].b = 0x66;
+    uint8_t buffer[WS2812_ENCODED_SIZE(sizeof(leds))];
+    uint16_t length = ws2812_encode((const uint8_t *)leds, sizeof(leds), buffer);
+    ASSERT_EQ(length, sizeof(buffer));
+
+    std::vector<int> bits = spi_bits(buffer, length);
+    std::vector<uint8_t> decoded = decode(bits, sizeof(leds) * 8);
+    EXPECT_EQ(decoded, std::vector<uint8_t>({0x22, 0x11, 0x33, 0x55, 0x44, 0x66}));
+
+    // the line stays low long enough for the strip to latch
+    for (int i = 0; i < WS2812_RESET_BYTES; i++) {
+        EXPECT_EQ(buffer[sizeof(leds) * 3 + i], 0);
+    }
+}
+
+class Ws2812Frames : public testing::Test {
+protected:
+    ws2812_frames_t frames;
+
+    void SetUp() override {
+        ws2812_frames_init(&frames);
+    }
+
+    // What rgblight_set() does for a frame of the first leds LEDs
+    uint8_t send(uint16_t leds, uint16_t *length) {
+        *length = leds * sizeof(LED_TYPE);
+        uint8_t index = ws2812_frames_claim(&frames, length);
+        ws2812_frames_ready(&frames, index, *length);
+        return index;
+    }
+};
+
+TEST_F(Ws2812Frames, NothingToSendAtFirst) {
+    EXPECT_EQ(ws2812_frames_next(&frames), WS2812_NO_BUFFER);
+}
+
+TEST_F(Ws2812Frames, EncodesNextToTheFrameOnTheWire) {
+    uint16_t length;
+    uint8_t first = send(4, &length);
+    EXPECT_EQ(ws2812_frames_next(&frames), first);
+    uint8_t second = send(4, &length);
+    EXPECT_NE(second, first);
+    ws2812_frames_sent(&frames);
+    EXPECT_EQ(ws2812_frames_next(&frames), second);
+}
+
+TEST_F(Ws2812Frames, PartialFramesBackToBackKeepTheLongerLength) {
+    uint16_t length;
+    // LEDs 0-5 change, then only LED 0 before the sender got to the first
+    send(6, &length);
+    EXPECT_EQ(length, 6 * sizeof(LED_TYPE));
+    uint8_t index = send(1, &length);
+    EXPECT_EQ(length, 6 * sizeof(LED_TYPE));
+    EXPECT_EQ(ws2812_frames_next(&frames), index);
+    EXPECT_EQ(frames.data_length[index], 6 * sizeof(LED_TYPE));
+
+    // Taken back again before being sent, it still covers LEDs 0-5
+    ws2812_frames_sent(&frames);
+    send(6, &length);
+    send(2, &length);
+    send(1, &length);
+    EXPECT_EQ(length, 6 * sizeof(LED_TYPE));
+}
+
+TEST_F(Ws2812Frames, PartialFrameAfterASentFrameStaysShort) {
+    uint16_t length;
+    send(6, &length);
+    ws2812_frames_next(&frames);
+    send(1, &length);
+    EXPECT_EQ(length, 1 * sizeof(LED_TYPE));
+}
@@ -12,6 +12,10 @@
 #include "suspend.h"
 #include "wait.h"
 
+#ifdef I2C_QUEUE_ENABLE
+#include "i2c_queue.h"
+#endif
+
 /** \brief suspend idle
  *
  * FIXME: needs doc
@@ -46,6 +50,11 @@ void suspend_power_down(void) {
 	// also shouldn't power down USB
 
   suspend_power_down_kb();
+
+#ifdef I2C_QUEUE_ENABLE
+  // let any queued LED updates reach the bus before the host cuts power
+  i2c_queue_flush();
+#endif
 	// on AVR, this enables the watchdog for 15ms (max), and goes to
 	// SLEEP_MODE_PWR_DOWN
 
@@ -55,6 +55,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
     #include "audio.h"
 #endif /* AUDIO_ENABLE */
 
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_LINK_STATS)
+    #include "split_common/transport.h"
+#endif
+
 
 static bool command_common(uint8_t code);
 static void command_common_help(void);
@@ -261,6 +265,10 @@ static void print_status(void)
 #   if USB_COUNT_SOF
     print_val_hex8(usbSofCount);
 #   endif
+#endif
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_LINK_STATS)
+    transport_print_link_stats();
 #endif
 	return;
 }